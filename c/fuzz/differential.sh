@@ -0,0 +1,36 @@
+#!/bin/sh
+#
+#   Production Version - C/C# Differential Check
+#   Nick Daria (contact@nickdaria.com)
+#
+#   Feeds every file of a corpus (e.g. one produced by fuzz_codec) through the C
+#   and C# codecs and reports inputs where the decode outcome, re-encoded bytes
+#   or ToString output differ. Every input is compared, including ones the C
+#   strict decoder refuses.
+#
+#   Usage: differential.sh corpus_dir
+#
+
+set -eu
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+CORPUS=${1:?usage: differential.sh corpus_dir}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cc -O1 -std=c99 -I"$HERE/.." "$HERE/fuzz_dump.c" -o "$WORK/fuzz_dump"
+dotnet build -c Release -v quiet "$HERE/../../csharp/ProdVersion.FuzzDump" -o "$WORK/cs" >/dev/null
+
+find "$CORPUS" -type f | sort > "$WORK/files"
+"$WORK/fuzz_dump" < "$WORK/files" > "$WORK/c.txt"
+dotnet "$WORK/cs/ProdVersion.FuzzDump.dll" < "$WORK/files" > "$WORK/cs.txt"
+
+paste -d '\t' "$WORK/files" "$WORK/c.txt" "$WORK/cs.txt" | awk -F '\t' '
+    $2 != $3 {
+        printf "%s\n  C:  %s\n  C#: %s\n", $1, $2, $3
+        bad++
+    }
+    END {
+        printf "%d inputs, %d divergent\n", NR, bad
+        exit (bad > 0)
+    }'
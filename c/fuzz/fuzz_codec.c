@@ -0,0 +1,73 @@
+/*
+    Production Version - Codec Fuzz Target
+    Nick Daria (contact@nickdaria.com)
+
+    libFuzzer target for prodVersionDecodeBytes, prodVersionDecodeBytesStrict,
+    prodVersionEncodeBytes and prodVersionToString. Checks that:
+        - strict decode never accepts what the regular decoder rejects, and agrees with it
+        - encode(decode(x)) equals prodVersionCanonicalizeBytes(x)
+        - encoding is stable across a second decode/encode round trip
+        - prodVersionToString never overruns or leaves an unterminated string
+
+    Build:  clang -g -O1 -fsanitize=fuzzer,address,undefined -I.. fuzz_codec.c -o fuzz_codec
+    Run:    ./fuzz_codec corpus/
+*/
+
+#include <stdlib.h>
+
+#include "prodversion.h"
+
+#define FUZZ_CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "check failed: %s\n", #cond); abort(); } } while (0)
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    prodVersion_t version;
+    prodVersion_t strict;
+
+    bool ok = prodVersionDecodeBytes((const char*)data, size, &version);
+    prodVersionDecodeResult_t strictRes = prodVersionDecodeBytesStrict((const char*)data, size, &strict);
+
+    if (size < PRODVER_ENCODED_LEN) {
+        FUZZ_CHECK(!ok);
+        FUZZ_CHECK(strictRes == PRODVER_DECODE_ERR_ARGS);
+        return 0;
+    }
+
+    if (!ok) {
+        FUZZ_CHECK(strictRes == PRODVER_DECODE_ERR_STRUCTVER);
+        return 0;
+    }
+
+    //  Canonical re-encoding of the input
+    char encoded[PRODVER_ENCODED_LEN];
+    char canonical[PRODVER_ENCODED_LEN];
+    FUZZ_CHECK(prodVersionEncodeBytes(encoded, sizeof(encoded), &version) == PRODVER_ENCODED_LEN);
+    memcpy(canonical, data, PRODVER_ENCODED_LEN);
+    FUZZ_CHECK(prodVersionCanonicalizeBytes(canonical, sizeof(canonical)));
+    FUZZ_CHECK(memcmp(encoded, canonical, PRODVER_ENCODED_LEN) == 0);
+
+    if (strictRes == PRODVER_DECODE_OK) {
+        char strictEncoded[PRODVER_ENCODED_LEN];
+        FUZZ_CHECK(prodVersionEncodeBytes(strictEncoded, sizeof(strictEncoded), &strict) == PRODVER_ENCODED_LEN);
+        FUZZ_CHECK(memcmp(strictEncoded, encoded, PRODVER_ENCODED_LEN) == 0);
+    }
+
+    //  Round trip is stable
+    prodVersion_t again;
+    char reencoded[PRODVER_ENCODED_LEN];
+    FUZZ_CHECK(prodVersionDecodeBytes(encoded, sizeof(encoded), &again));
+    FUZZ_CHECK(prodVersionEncodeBytes(reencoded, sizeof(reencoded), &again) == PRODVER_ENCODED_LEN);
+    FUZZ_CHECK(memcmp(encoded, reencoded, PRODVER_ENCODED_LEN) == 0);
+
+    //  Formatting at every buffer size, with a guard byte past the end
+    char str[128];
+    for (size_t len = 1; len < sizeof(str); len++) {
+        str[len] = 0x5A;
+        size_t written = prodVersionToString(&version, str, len);
+        FUZZ_CHECK(str[len] == 0x5A);
+        FUZZ_CHECK(written < len);
+        FUZZ_CHECK(str[written] == '\0');
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+    Production Version - Differential Dump (C)
+    Nick Daria (contact@nickdaria.com)
+
+    Reads newline-separated input file paths on stdin and prints one line per
+    input, in the same format as csharp/ProdVersion.FuzzDump, so the two codecs
+    can be diffed by differential.sh:
+        skip                    Not exactly 64 bytes
+        reject                  Unsupported structure version
+        accept <hex> <hex>      Re-encoded bytes and prodVersionToString output
+
+    Every structure version 1 input is decoded with the regular decoder and
+    compared, including ones the strict decoder refuses (non-ASCII characters,
+    unknown channels, garbage after terminators), since those are where the two
+    implementations are most likely to diverge. The string is dumped as hex so
+    control characters and embedded NULs (channel byte 0) survive.
+
+    Build:  cc -O1 -std=c99 -I.. fuzz_dump.c -o fuzz_dump
+*/
+
+#include "prodversion.h"
+
+int main(void)
+{
+    char path[4096];
+    while (fgets(path, sizeof(path), stdin)) {
+        path[strcspn(path, "\r\n")] = '\0';
+
+        FILE* f = fopen(path, "rb");
+        if (!f) {
+            perror(path);
+            return 1;
+        }
+
+        char buf[PRODVER_ENCODED_LEN + 1];
+        size_t size = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+
+        prodVersion_t version;
+        if (size != PRODVER_ENCODED_LEN) {
+            puts("skip");
+            continue;
+        }
+        if (!prodVersionDecodeBytes(buf, size, &version)) {
+            puts("reject");
+            continue;
+        }
+
+        char encoded[PRODVER_ENCODED_LEN];
+        char str[128];
+        prodVersionEncodeBytes(encoded, sizeof(encoded), &version);
+        size_t strLen = prodVersionToString(&version, str, sizeof(str));
+
+        printf("accept ");
+        for (size_t i = 0; i < PRODVER_ENCODED_LEN; i++) {
+            printf("%02x", (uint8_t)encoded[i]);
+        }
+        putchar(' ');
+        for (size_t i = 0; i < strLen; i++) {
+            printf("%02x", (uint8_t)str[i]);
+        }
+        putchar('\n');
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+    Production Version - Shared Library
+    Nick Daria (contact@nickdaria.com)
+
+    Exports the header-only codec under the stable ABI in libprodversion.h.
+    Build with CMake (c/CMakeLists.txt).
+*/
+
+#include "libprodversion.h"
+
+//  Per-ISA variants of the batch loops, dispatched by an ifunc resolver at load time
+#if defined(PRODVER_TARGET_CLONES)
+    #define PRODVER_BATCH             __attribute__((target_clones("avx2", "sse4.2", "default")))
+#else
+    #define PRODVER_BATCH
+#endif
+
+uint32_t prodVersionAbiVersion(void)
+{
+    return PRODVER_ABI_VERSION;
+}
+
+size_t prodVersionAbiStructSize(void)
+{
+    return sizeof(prodVersion_t);
+}
+
+size_t prodVersionAbiEncode(char* ret_buf, size_t len, const prodVersion_t* version)
+{
+    return prodVersionEncodeBytes(ret_buf, len, version);
+}
+
+bool prodVersionAbiDecode(const char* buf, size_t len, prodVersion_t* ret_version)
+{
+    return prodVersionDecodeBytes(buf, len, ret_version);
+}
+
+int prodVersionAbiDecodeStrict(const char* buf, size_t len, prodVersion_t* ret_version)
+{
+    return (int)prodVersionDecodeBytesStrict(buf, len, ret_version);
+}
+
+size_t prodVersionAbiToString(const prodVersion_t* version, char* ret_str, size_t buf_len)
+{
+    return prodVersionToString(version, ret_str, buf_len);
+}
+
+int prodVersionAbiCompare(const prodVersion_t* a, const prodVersion_t* b)
+{
+    if (!a || !b) {
+        return 0;
+    }
+    return prodVersionCompare(a, b);
+}
+
+bool prodVersionAbiChannelEligible(prodVersionChannel_t device, prodVersionChannel_t build)
+{
+    return prodVersionChannelEligible(device, build);
+}
+
+PRODVER_BATCH
+size_t prodVersionAbiDecodeBatch(const char* buf, size_t count, prodVersion_t* ret_versions, uint8_t* ret_ok)
+{
+    if (!buf || !ret_versions) {
+        return 0;
+    }
+
+    size_t decoded = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool ok = prodVersionDecodeBytes(buf + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &ret_versions[i]);
+        if (!ok) {
+            memset(&ret_versions[i], 0, sizeof(prodVersion_t));
+        }
+        if (ret_ok) {
+            ret_ok[i] = (uint8_t)ok;
+        }
+        decoded += ok;
+    }
+    return decoded;
+}
+
+PRODVER_BATCH
+size_t prodVersionAbiEncodeBatch(char* ret_buf, const prodVersion_t* versions, size_t count)
+{
+    if (!ret_buf || !versions) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!prodVersionEncodeBytes(ret_buf + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &versions[i])) {
+            return i;
+        }
+    }
+    return count;
+}
+
+PRODVER_BATCH
+void prodVersionAbiPeekSemverBatch(const char* buf, size_t count, uint64_t* ret_keys)
+{
+    if (!buf || !ret_keys) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ret_keys[i] = prodVersionPeekSemver(buf + i * PRODVER_ENCODED_LEN);
+    }
+}
+
+PRODVER_BATCH
+void prodVersionAbiPeekDateBatch(const char* buf, size_t count, uint64_t* ret_dates)
+{
+    if (!buf || !ret_dates) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ret_dates[i] = prodVersionPeekDate(buf + i * PRODVER_ENCODED_LEN);
+    }
+}
+
+PRODVER_BATCH
+size_t prodVersionAbiFilterBatch(const char* buf, size_t count, uint64_t minKey, uint8_t accepts, uint8_t* ret_match)
+{
+    if (!buf || !ret_match) {
+        return 0;
+    }
+
+    size_t matched = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool match = prodVersionBootCheck(buf + i * PRODVER_ENCODED_LEN, minKey, accepts);
+        ret_match[i] = (uint8_t)match;
+        matched += match;
+    }
+    return matched;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+    Production Version - Shared Library ABI
+    Nick Daria (contact@nickdaria.com)
+
+    Exported entry points of libprodversion, for consumers that cannot use the
+    header-only library (Python, Go, Rust and other FFI users). Functions keep
+    their signatures for a given PRODVER_ABI_VERSION; additions bump the minor
+    library version, breaking changes bump the ABI version and soname.
+
+    prodVersion_t is part of the ABI. FFI bindings that mirror it should check
+    prodVersionAbiStructSize() at load time.
+
+    Batch functions take back-to-back PRODVER_ENCODED_LEN byte records. On
+    x86-64 they are built for several instruction sets and the best variant is
+    selected by the loader (ifunc).
+*/
+
+#include "../prodversion.h"
+
+/// ABI version, matches the library soname
+#define PRODVER_ABI_VERSION           1
+
+#if defined(_WIN32)
+    #if defined(PRODVER_BUILDING_LIB)
+        #define PRODVER_API           __declspec(dllexport)
+    #else
+        #define PRODVER_API           __declspec(dllimport)
+    #endif
+#elif defined(__GNUC__)
+    #define PRODVER_API               __attribute__((visibility("default")))
+#else
+    #define PRODVER_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @return PRODVER_ABI_VERSION the library was built with.
+PRODVER_API uint32_t prodVersionAbiVersion(void);
+
+/// @return sizeof(prodVersion_t) the library was built with.
+PRODVER_API size_t prodVersionAbiStructSize(void);
+
+/// @brief See prodVersionEncodeBytes.
+PRODVER_API size_t prodVersionAbiEncode(char* ret_buf, size_t len, const prodVersion_t* version);
+
+/// @brief See prodVersionDecodeBytes.
+PRODVER_API bool prodVersionAbiDecode(const char* buf, size_t len, prodVersion_t* ret_version);
+
+/// @brief See prodVersionDecodeBytesStrict.
+/// @return prodVersionDecodeResult_t value.
+PRODVER_API int prodVersionAbiDecodeStrict(const char* buf, size_t len, prodVersion_t* ret_version);
+
+/// @brief See prodVersionToString.
+PRODVER_API size_t prodVersionAbiToString(const prodVersion_t* version, char* ret_str, size_t buf_len);
+
+/// @brief See prodVersionCompare.
+PRODVER_API int prodVersionAbiCompare(const prodVersion_t* a, const prodVersion_t* b);
+
+/// @brief See prodVersionChannelEligible.
+PRODVER_API bool prodVersionAbiChannelEligible(prodVersionChannel_t device, prodVersionChannel_t build);
+
+/// @brief Decodes count records.
+/// @param buf count * PRODVER_ENCODED_LEN bytes.
+/// @param count Number of records.
+/// @param ret_versions Destination for count versions.
+/// @param ret_ok Optional, per-record 1 if decoded or 0 if rejected (rejected versions are zeroed).
+/// @return Number of records decoded.
+PRODVER_API size_t prodVersionAbiDecodeBatch(const char* buf, size_t count, prodVersion_t* ret_versions, uint8_t* ret_ok);
+
+/// @brief Encodes count versions.
+/// @param ret_buf Destination for count * PRODVER_ENCODED_LEN bytes.
+/// @param versions Versions to encode.
+/// @param count Number of versions.
+/// @return Number of records encoded, stops at the first failure.
+PRODVER_API size_t prodVersionAbiEncodeBatch(char* ret_buf, const prodVersion_t* versions, size_t count);
+
+/// @brief Reads prodVersionPeekSemver keys of count records.
+PRODVER_API void prodVersionAbiPeekSemverBatch(const char* buf, size_t count, uint64_t* ret_keys);
+
+/// @brief Reads dates of count records.
+PRODVER_API void prodVersionAbiPeekDateBatch(const char* buf, size_t count, uint64_t* ret_dates);
+
+/// @brief Applies prodVersionBootCheck to count records.
+/// @param ret_match Per-record 1 if the record is newer than minKey on an accepted channel, else 0.
+/// @return Number of matching records.
+PRODVER_API size_t prodVersionAbiFilterBatch(const char* buf, size_t count, uint64_t minKey, uint8_t accepts, uint8_t* ret_match);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,6 +20,18 @@
 #define PRODVER_FLD_METADATA_LEN      15
 #define PRODVER_FLD_COMMIT_LEN        7
 
+/// Byte offsets of each field within the 64-byte encoding
+#define PRODVER_OFS_STRUCTVER         0
+#define PRODVER_OFS_PRODUCT           1
+#define PRODVER_OFS_MAJOR             25
+#define PRODVER_OFS_MINOR             27
+#define PRODVER_OFS_PATCH             29
+#define PRODVER_OFS_BUILD             31
+#define PRODVER_OFS_CHANNEL           33
+#define PRODVER_OFS_METADATA          34
+#define PRODVER_OFS_COMMIT            49
+#define PRODVER_OFS_DATE              56
+
 /// @brief Unique character indicating the release channel
 typedef enum {
     VERSION_CHANNEL_DEV          = 'd',      //  Non-functional development/bench testing
@@ -32,6 +44,94 @@ typedef enum {
     VERSION_CHANNEL_FACTORY      = 'f',      //  Factory build (non functional test/updater software)
 } prodVersionChannel_t;
 
+/// Number of release channels defined by prodVersionChannel_t
+#define PRODVER_CHANNEL_COUNT         7
+
+/// @brief Maps a release channel to a dense index for per-channel tables.
+/// @param channel Release channel character.
+/// @return Index in [0, PRODVER_CHANNEL_COUNT), or -1 if not a known channel.
+static inline int prodVersionChannelIndex(prodVersionChannel_t channel)
+{
+    switch (channel) {
+        case VERSION_CHANNEL_DEV:       return 0;
+        case VERSION_CHANNEL_INTERNAL:  return 1;
+        case VERSION_CHANNEL_ALPHA:     return 2;
+        case VERSION_CHANNEL_BETA:      return 3;
+        case VERSION_CHANNEL_CANDIDATE: return 4;
+        case VERSION_CHANNEL_RELEASE:   return 5;
+        case VERSION_CHANNEL_FACTORY:   return 6;
+        default:                        return -1;
+    }
+}
+
+/// @brief Bit for a channel in eligibility masks, (1 << prodVersionChannelIndex), or 0 for unknown channels.
+#define PRODVER_CHANNEL_BIT(channel)  (prodVersionChannelMask(channel))
+
+/// Mask of every channel on the stability ladder (dev through release)
+#define PRODVER_CHANNEL_MASK_LADDER   ((uint8_t)0x3F)
+
+/// @brief Stability rank of a channel, higher is more stable.
+/// @note Dev through release rank 1 - 6. Factory sits outside the ladder and unknown channels rank 0.
+/// @param channel Release channel character.
+/// @return Rank, or 0 if unranked.
+static inline uint8_t prodVersionChannelRank(prodVersionChannel_t channel)
+{
+    switch (channel) {
+        case VERSION_CHANNEL_DEV:       return 1;
+        case VERSION_CHANNEL_INTERNAL:  return 2;
+        case VERSION_CHANNEL_ALPHA:     return 3;
+        case VERSION_CHANNEL_BETA:      return 4;
+        case VERSION_CHANNEL_CANDIDATE: return 5;
+        case VERSION_CHANNEL_RELEASE:   return 6;
+        default:                        return 0;
+    }
+}
+
+/// @brief Single-bit mask identifying a build's channel.
+/// @param channel Release channel character.
+/// @return 1 << prodVersionChannelIndex(channel), or 0 for unknown channels.
+static inline uint8_t prodVersionChannelMask(prodVersionChannel_t channel)
+{
+    switch (channel) {
+        case VERSION_CHANNEL_DEV:       return 0x01;
+        case VERSION_CHANNEL_INTERNAL:  return 0x02;
+        case VERSION_CHANNEL_ALPHA:     return 0x04;
+        case VERSION_CHANNEL_BETA:      return 0x08;
+        case VERSION_CHANNEL_CANDIDATE: return 0x10;
+        case VERSION_CHANNEL_RELEASE:   return 0x20;
+        case VERSION_CHANNEL_FACTORY:   return 0x40;
+        default:                        return 0;
+    }
+}
+
+/// @brief Mask of build channels a device on the given channel may install.
+/// @note A device accepts its own channel and every more stable one (a beta device takes beta, candidate and release).
+/// Factory devices accept factory and release builds. Unknown channels accept nothing.
+/// @param channel Device's release channel character.
+/// @return Eligibility mask to AND against prodVersionChannelMask of a build.
+static inline uint8_t prodVersionChannelAccepts(prodVersionChannel_t channel)
+{
+    switch (channel) {
+        case VERSION_CHANNEL_DEV:       return 0x3F;
+        case VERSION_CHANNEL_INTERNAL:  return 0x3E;
+        case VERSION_CHANNEL_ALPHA:     return 0x3C;
+        case VERSION_CHANNEL_BETA:      return 0x38;
+        case VERSION_CHANNEL_CANDIDATE: return 0x30;
+        case VERSION_CHANNEL_RELEASE:   return 0x20;
+        case VERSION_CHANNEL_FACTORY:   return 0x60;
+        default:                        return 0;
+    }
+}
+
+/// @brief Checks if a device on one channel may install a build from another.
+/// @param device Channel the device is subscribed to.
+/// @param build Channel the candidate build was released on.
+/// @return True if eligible.
+static inline bool prodVersionChannelEligible(prodVersionChannel_t device, prodVersionChannel_t build)
+{
+    return (prodVersionChannelAccepts(device) & prodVersionChannelMask(build)) != 0;
+}
+
 typedef struct {
     //  Product/Part Identifier
     char product[PRODVER_FLD_PRODUCT_LEN + 1];
@@ -61,6 +161,18 @@ typedef struct {
     uint64_t date;
 } prodVersion_t;
 
+/// @brief Copies a string into a fixed-length field, zero padding after it and truncating at len (no terminator then).
+/// @note Used instead of strncpy, which compilers flag for the intentional truncation.
+static inline void prodVersionCopyField(char* dst, const char* src, const size_t len)
+{
+    size_t n = 0;
+    while (n < len && src[n]) {
+        n++;
+    }
+    memcpy(dst, src, n);
+    memset(dst + n, 0, len - n);
+}
+
 /// @brief Encodes a version structure into a fixed 64-byte array, matching the C# library.
 /// @param ret_buf Destination buffer (must be at least 64 bytes).
 /// @param len Length of ret_buf.
@@ -78,8 +190,7 @@ static inline size_t prodVersionEncodeBytes(char* ret_buf, const size_t len, con
     ret_buf[offset++] = PRODVER_STRUCTVER;
 
     //  Product/Part identifier
-    memset(ret_buf + offset, 0, PRODVER_FLD_PRODUCT_LEN);
-    strncpy(ret_buf + offset, version->product, PRODVER_FLD_PRODUCT_LEN);
+    prodVersionCopyField(ret_buf + offset, version->product, PRODVER_FLD_PRODUCT_LEN);
     offset += PRODVER_FLD_PRODUCT_LEN;
 
     //  Semantic versioning
@@ -99,13 +210,11 @@ static inline size_t prodVersionEncodeBytes(char* ret_buf, const size_t len, con
     ret_buf[offset++] = (char)version->releaseChannel;
 
     //  Metadata
-    memset(ret_buf + offset, 0, PRODVER_FLD_METADATA_LEN);
-    strncpy(ret_buf + offset, version->metadata, PRODVER_FLD_METADATA_LEN);
+    prodVersionCopyField(ret_buf + offset, version->metadata, PRODVER_FLD_METADATA_LEN);
     offset += PRODVER_FLD_METADATA_LEN;
 
     //  Commit identifier
-    memset(ret_buf + offset, 0, PRODVER_FLD_COMMIT_LEN);
-    strncpy(ret_buf + offset, version->commitHash, PRODVER_FLD_COMMIT_LEN);
+    prodVersionCopyField(ret_buf + offset, version->commitHash, PRODVER_FLD_COMMIT_LEN);
     offset += PRODVER_FLD_COMMIT_LEN;
 
     //  Date
@@ -119,8 +228,7 @@ static inline size_t prodVersionEncodeBytes(char* ret_buf, const size_t len, con
     ret_buf[offset++] = (char)((d >>  8) & 0xFF);
     ret_buf[offset++] = (char)( d        & 0xFF);
 
-    //  Ignore last increment
-    return offset - 1;
+    return offset;
 }
 
 /// @brief Decodes a 64-byte array into a version struct, matching the C# library.
@@ -185,6 +293,252 @@ static inline bool prodVersionDecodeBytes(const char* buf, const size_t len, pro
     return true;
 }
 
+/// @brief Result of a strict decode, identifying the first field that failed validation
+typedef enum {
+    PRODVER_DECODE_OK = 0,
+    PRODVER_DECODE_ERR_ARGS,                //  NULL pointer or buffer shorter than PRODVER_ENCODED_LEN
+    PRODVER_DECODE_ERR_STRUCTVER,           //  Unsupported structure version
+    PRODVER_DECODE_ERR_PRODUCT_CHAR,        //  Non-printable ASCII before the terminator
+    PRODVER_DECODE_ERR_PRODUCT_PADDING,     //  Non-zero byte after the terminator
+    PRODVER_DECODE_ERR_CHANNEL,             //  Not a known prodVersionChannel_t
+    PRODVER_DECODE_ERR_METADATA_CHAR,
+    PRODVER_DECODE_ERR_METADATA_PADDING,
+    PRODVER_DECODE_ERR_COMMIT_CHAR,
+    PRODVER_DECODE_ERR_COMMIT_PADDING,
+} prodVersionDecodeResult_t;
+
+/// @brief Copies an encoded string field while checking it is printable ASCII followed only by zero padding.
+/// @return 0 if valid, 1 on a bad character, 2 on non-zero padding.
+static inline int prodVersionCopyStrictField(char* dst, const char* src, const size_t len)
+{
+    uint8_t terminated = 0;
+    uint8_t badChar = 0;
+    uint8_t badPad = 0;
+
+    //  Branch-free per byte so the whole field is checked without early exits
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)src[i];
+        terminated |= (uint8_t)(c == 0);
+        badChar |= (uint8_t)((terminated ^ 1) & ((c < 0x20) | (c > 0x7E)));
+        badPad |= (uint8_t)(terminated & (c != 0));
+        dst[i] = (char)c;
+    }
+    dst[len] = '\0';
+
+    return badChar ? 1 : (badPad ? 2 : 0);
+}
+
+/// @brief Decodes a 64-byte array like prodVersionDecodeBytes, rejecting unknown channels,
+/// non-printable characters and garbage after string terminators in the same pass.
+/// @param buf Source data (must be at least 64 bytes).
+/// @param len Length of buf.
+/// @param ret_version Destination struct, contents are unspecified on failure.
+/// @return PRODVER_DECODE_OK on success, otherwise the first failing check.
+static inline prodVersionDecodeResult_t prodVersionDecodeBytesStrict(const char* buf, const size_t len, prodVersion_t* ret_version)
+{
+    if (!buf || !ret_version || len < PRODVER_ENCODED_LEN) {
+        return PRODVER_DECODE_ERR_ARGS;
+    }
+
+    size_t offset = 0;
+    int field;
+
+    //  Validate structure version
+    if ((uint8_t)buf[offset++] != PRODVER_STRUCTVER) {
+        return PRODVER_DECODE_ERR_STRUCTVER;
+    }
+
+    //  Product
+    field = prodVersionCopyStrictField(ret_version->product, buf + offset, PRODVER_FLD_PRODUCT_LEN);
+    if (field) {
+        return (prodVersionDecodeResult_t)(PRODVER_DECODE_ERR_PRODUCT_CHAR + field - 1);
+    }
+    offset += PRODVER_FLD_PRODUCT_LEN;
+
+    //  Semantic Versioning
+    ret_version->major = (uint16_t)(((uint8_t)buf[offset] << 8) | (uint8_t)buf[offset + 1]);
+    offset += 2;
+    ret_version->minor = (uint16_t)(((uint8_t)buf[offset] << 8) | (uint8_t)buf[offset + 1]);
+    offset += 2;
+    ret_version->patch = (uint16_t)(((uint8_t)buf[offset] << 8) | (uint8_t)buf[offset + 1]);
+    offset += 2;
+    ret_version->build = (uint16_t)(((uint8_t)buf[offset] << 8) | (uint8_t)buf[offset + 1]);
+    offset += 2;
+
+    //  Release channel
+    ret_version->releaseChannel = (prodVersionChannel_t)buf[offset++];
+    if (prodVersionChannelMask(ret_version->releaseChannel) == 0) {
+        return PRODVER_DECODE_ERR_CHANNEL;
+    }
+
+    //  Metadata
+    field = prodVersionCopyStrictField(ret_version->metadata, buf + offset, PRODVER_FLD_METADATA_LEN);
+    if (field) {
+        return (prodVersionDecodeResult_t)(PRODVER_DECODE_ERR_METADATA_CHAR + field - 1);
+    }
+    offset += PRODVER_FLD_METADATA_LEN;
+
+    //  Commit hash
+    field = prodVersionCopyStrictField(ret_version->commitHash, buf + offset, PRODVER_FLD_COMMIT_LEN);
+    if (field) {
+        return (prodVersionDecodeResult_t)(PRODVER_DECODE_ERR_COMMIT_CHAR + field - 1);
+    }
+    offset += PRODVER_FLD_COMMIT_LEN;
+
+    //  Date
+    uint64_t d = 0;
+    for (int i = 0; i < 8; i++) {
+        d = (d << 8) | (uint8_t)buf[offset++];
+    }
+    ret_version->date = d;
+
+    return PRODVER_DECODE_OK;
+}
+
+/// @brief Zeroes every byte after the first terminator of a fixed-length string field.
+static inline void prodVersionCanonicalizeField(char* field, const size_t len)
+{
+    size_t i = 0;
+    while (i < len && field[i]) {
+        i++;
+    }
+    memset(field + i, 0, len - i);
+}
+
+/// @brief Puts a version struct's string fields in canonical form.
+/// @note String fields are zero-filled after their terminator, including the reserved last byte, so each
+/// field of identical versions compares equal with memcmp. The struct as a whole has padding that is not
+/// touched, so hash or memcmp the 64-byte encoding (always canonical) rather than the struct.
+/// @param version Version to canonicalize in place.
+static inline void prodVersionCanonicalize(prodVersion_t* version)
+{
+    if (!version) {
+        return;
+    }
+
+    prodVersionCanonicalizeField(version->product, PRODVER_FLD_PRODUCT_LEN + 1);
+    prodVersionCanonicalizeField(version->metadata, PRODVER_FLD_METADATA_LEN + 1);
+    prodVersionCanonicalizeField(version->commitHash, PRODVER_FLD_COMMIT_LEN + 1);
+}
+
+/// @brief Canonicalizes an encoded version in place so equal versions have identical 64 bytes.
+/// @param buf Encoded version (must be at least 64 bytes).
+/// @param len Length of buf.
+/// @return True on success, false on error or bad version.
+static inline bool prodVersionCanonicalizeBytes(char* buf, const size_t len)
+{
+    if (!buf || len < PRODVER_ENCODED_LEN || (uint8_t)buf[0] != PRODVER_STRUCTVER) {
+        return false;
+    }
+
+    prodVersionCanonicalizeField(buf + PRODVER_OFS_PRODUCT, PRODVER_FLD_PRODUCT_LEN);
+    prodVersionCanonicalizeField(buf + PRODVER_OFS_METADATA, PRODVER_FLD_METADATA_LEN);
+    prodVersionCanonicalizeField(buf + PRODVER_OFS_COMMIT, PRODVER_FLD_COMMIT_LEN);
+    return true;
+}
+
+/// @brief Reads the date of an encoded version without decoding the rest.
+/// @param buf Encoded version (must be at least 64 bytes, not validated).
+/// @return Seconds since Unix epoch.
+static inline uint64_t prodVersionPeekDate(const char* buf)
+{
+    uint64_t d = 0;
+    for (int i = 0; i < 8; i++) {
+        d = (d << 8) | (uint8_t)buf[PRODVER_OFS_DATE + i];
+    }
+    return d;
+}
+
+/// @brief Packs semantic version and build into one key, ordered like prodVersionCompare.
+static inline uint64_t prodVersionPackSemver(const prodVersion_t* version)
+{
+    return ((uint64_t)version->major << 48) | ((uint64_t)version->minor << 32) |
+           ((uint64_t)version->patch << 16) | (uint64_t)version->build;
+}
+
+/// @brief Reads major, minor, patch and build of an encoded version as one key.
+/// @note The four big-endian fields are contiguous, so the key equals major << 48 | minor << 32 | patch << 16 | build.
+/// @param buf Encoded version (must be at least 64 bytes, not validated).
+/// @return Packed semantic version key, ordered like prodVersionCompare.
+static inline uint64_t prodVersionPeekSemver(const char* buf)
+{
+    //  Assembled from 32-bit halves so 32-bit cores avoid 64-bit shift chains
+    const uint8_t* p = (const uint8_t*)buf + PRODVER_OFS_MAJOR;
+    uint32_t hi = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    uint32_t lo = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | (uint32_t)p[7];
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/// @brief Reads the release channel of an encoded version without decoding the rest.
+/// @param buf Encoded version (must be at least 64 bytes, not validated).
+static inline prodVersionChannel_t prodVersionPeekChannel(const char* buf)
+{
+    return (prodVersionChannel_t)(uint8_t)buf[PRODVER_OFS_CHANNEL];
+}
+
+/// @brief Bootloader check on an encoded version in place (e.g. memory-mapped flash),
+/// without copying it or touching its strings.
+/// @param buf Encoded version (at least 64 bytes readable).
+/// @param minKey The image must be newer than this prodVersionPackSemver key.
+/// @param accepts Allowed channels, e.g. prodVersionChannelAccepts(deviceChannel).
+/// @return True if the structure version is supported, the image is newer than minKey and its channel is allowed.
+static inline bool prodVersionBootCheck(const char* buf, const uint64_t minKey, const uint8_t accepts)
+{
+    return (uint8_t)buf[PRODVER_OFS_STRUCTVER] == PRODVER_STRUCTVER &&
+           (accepts & prodVersionChannelMask(prodVersionPeekChannel(buf))) != 0 &&
+           prodVersionPeekSemver(buf) > minKey;
+}
+
+/// @brief FNV-1a hash of a string field, stopping at the terminator or maxLen.
+static inline uint32_t prodVersionHashString(const char* str, const size_t maxLen)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < maxLen && str[i]; i++) {
+        h ^= (uint8_t)str[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/// @brief Packs a commit hash field into an integer key, first character in the most significant used byte.
+/// @note Stops at the terminator, so the key of a canonical field round-trips and keys sort like the strings.
+/// @param commitHash Commit hash string, at most PRODVER_FLD_COMMIT_LEN characters are read.
+/// @return Packed key in the low 56 bits.
+static inline uint64_t prodVersionPackCommit(const char* commitHash)
+{
+    uint64_t key = 0;
+    size_t i = 0;
+    for (; i < PRODVER_FLD_COMMIT_LEN && commitHash[i]; i++) {
+        key = (key << 8) | (uint8_t)commitHash[i];
+    }
+    return key << (8 * (PRODVER_FLD_COMMIT_LEN - i));
+}
+
+/// @brief Unpacks a key from prodVersionPackCommit into a null-terminated commit hash.
+/// @param key Packed key.
+/// @param ret_commitHash Destination, at least PRODVER_FLD_COMMIT_LEN + 1 bytes.
+static inline void prodVersionUnpackCommit(const uint64_t key, char* ret_commitHash)
+{
+    for (size_t i = 0; i < PRODVER_FLD_COMMIT_LEN; i++) {
+        ret_commitHash[i] = (char)((key >> (8 * (PRODVER_FLD_COMMIT_LEN - 1 - i))) & 0xFF);
+    }
+    ret_commitHash[PRODVER_FLD_COMMIT_LEN] = '\0';
+}
+
+/// @brief Orders two versions by semantic version, then build number.
+/// @note Product, channel, metadata and date are not considered.
+/// @param a First version.
+/// @param b Second version.
+/// @return Negative if a is older than b, 0 if equal, positive if a is newer.
+static inline int prodVersionCompare(const prodVersion_t* a, const prodVersion_t* b)
+{
+    if (a->major != b->major) return (a->major < b->major) ? -1 : 1;
+    if (a->minor != b->minor) return (a->minor < b->minor) ? -1 : 1;
+    if (a->patch != b->patch) return (a->patch < b->patch) ? -1 : 1;
+    if (a->build != b->build) return (a->build < b->build) ? -1 : 1;
+    return 0;
+}
+
 /// @brief Converts a version to a human-readable string.
 /// @param version Pointer to version struct
 /// @param ret_str Buffer to write string to
@@ -201,11 +555,17 @@ static inline size_t prodVersionToString(const prodVersion_t* version, char* ret
         return 0;
     }
 
+    //  Build suffix is omitted for build 0, matching the C# library
+    char build[16] = "";
+    if (version->build) {
+        snprintf(build, sizeof(build), " build %u", version->build);
+    }
+
     // Example: "MYPRODUCT 1.2.3a-something (abc1234) build 42"
     int written = snprintf(
         ret_str,
         buf_len,
-        "%s %u.%u.%u%c%s%s%s%s%s%c",
+        "%s %u.%u.%u%c%s%s%s%s%s%s",
         version->product[0] ? version->product : "",
         version->major,
         version->minor,
@@ -219,7 +579,7 @@ static inline size_t prodVersionToString(const prodVersion_t* version, char* ret
             ? version->commitHash : "",
         (version->releaseChannel != VERSION_CHANNEL_RELEASE)
             ? ")" : "",
-        version->build
+        build
     );
 
     if (written < 0 || (size_t)written >= buf_len) {
@@ -0,0 +1,361 @@
+#pragma once
+
+/*
+    Production Version - Columnar Archive
+    Nick Daria (contact@nickdaria.com)
+
+    Compresses blocks of 64-byte encoded records for long-term snapshot
+    storage. Within a block, product, metadata and commitHash are dictionary
+    encoded and every column (dictionary indexes, major, minor, patch, build,
+    channel, date) is frame-of-reference encoded: a base value plus bit-packed
+    offsets using the fewest bits that fit the block's range. Blocks decompress
+    straight back into canonical 64-byte encodings.
+
+    Block layout (big-endian):
+        [0]         PRODVER_ARCHIVE_VER
+        [1 - 4]     Record count
+                    Product, metadata and commit dictionaries, each:
+                        uint16 entry count, then per entry uint8 length + characters
+                    Columns in prodVersionArchiveColumn_t order, each:
+                        uint64 base, uint8 bit width, ceil(count * width / 8) packed bytes (LSB first)
+*/
+
+#include "prodversion_intern.h"
+
+/// The current version of the archive block format
+#define PRODVER_ARCHIVE_VER           1
+
+/// Records per block, bounds the work area
+#define PRODVER_ARCHIVE_BLOCK_RECORDS 4096
+
+#define PRODVER_ARCHIVE_HEADER_LEN    5
+
+/// Number of dictionary-encoded string columns (product, metadata, commit)
+#define PRODVER_ARCHIVE_DICTS         3
+
+/// @brief Largest block prodVersionArchiveEncodeBlock can produce for count records, to size its buffer.
+/// @note Worst case is every string distinct and full length (1 + 24, 1 + 15, 1 + 7 = 49 bytes of dictionary)
+/// plus 21.5 bytes of packed columns (three 12-bit indexes, four 16-bit fields, 8-bit channel, 64-bit date)
+/// per record, and per dictionary a 2-byte count and per column a 9-byte header and a partial byte.
+#define PRODVER_ARCHIVE_MAX_LEN(count) \
+    (PRODVER_ARCHIVE_HEADER_LEN + PRODVER_ARCHIVE_DICTS * 2 + PRODVER_ARCHIVE_COLUMNS * 10 + ((size_t)(count) * 141 + 1) / 2)
+
+typedef enum {
+    PRODVER_ARCHIVE_COL_PRODUCT = 0,
+    PRODVER_ARCHIVE_COL_METADATA,
+    PRODVER_ARCHIVE_COL_COMMIT,
+    PRODVER_ARCHIVE_COL_MAJOR,
+    PRODVER_ARCHIVE_COL_MINOR,
+    PRODVER_ARCHIVE_COL_PATCH,
+    PRODVER_ARCHIVE_COL_BUILD,
+    PRODVER_ARCHIVE_COL_CHANNEL,
+    PRODVER_ARCHIVE_COL_DATE,
+
+    PRODVER_ARCHIVE_COLUMNS
+} prodVersionArchiveColumn_t;
+
+
+/// @brief Scratch memory for encoding and decoding a block (several hundred KiB, allocate once and reuse)
+typedef struct {
+    prodVersionIntern_t dicts[PRODVER_ARCHIVE_DICTS];
+    prodVersionInternStr_t strings[PRODVER_ARCHIVE_DICTS][PRODVER_ARCHIVE_BLOCK_RECORDS];
+    uint32_t slots[PRODVER_ARCHIVE_DICTS][PRODVER_ARCHIVE_BLOCK_RECORDS * 2];
+    uint64_t columns[PRODVER_ARCHIVE_COLUMNS][PRODVER_ARCHIVE_BLOCK_RECORDS];
+} prodVersionArchiveWork_t;
+
+/// @brief Offset and length of each string field within the 64-byte encoding, in dictionary order
+static inline void prodVersionArchiveDictField(const int dict, size_t* ret_offset, size_t* ret_len)
+{
+    static const uint8_t offsets[PRODVER_ARCHIVE_DICTS] = { PRODVER_OFS_PRODUCT, PRODVER_OFS_METADATA, PRODVER_OFS_COMMIT };
+    static const uint8_t lens[PRODVER_ARCHIVE_DICTS] = { PRODVER_FLD_PRODUCT_LEN, PRODVER_FLD_METADATA_LEN, PRODVER_FLD_COMMIT_LEN };
+    *ret_offset = offsets[dict];
+    *ret_len = lens[dict];
+}
+
+/// @brief Reads a big-endian unsigned integer of up to 8 bytes.
+static inline uint64_t prodVersionArchiveReadBE(const char* buf, const size_t bytes)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        v = (v << 8) | (uint8_t)buf[i];
+    }
+    return v;
+}
+
+/// @brief Writes a big-endian unsigned integer of up to 8 bytes.
+static inline void prodVersionArchiveWriteBE(char* buf, const uint64_t value, const size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) {
+        buf[i] = (char)((value >> (8 * (bytes - 1 - i))) & 0xFF);
+    }
+}
+
+/// @brief Bytes needed for count values of a given bit width.
+static inline size_t prodVersionArchivePackedLen(const size_t count, const uint8_t width)
+{
+    return (count * width + 7) / 8;
+}
+
+/// @brief Bit-packs count values, LSB first. Destination must be zeroed.
+static inline void prodVersionArchivePack(char* ret_buf, const uint64_t* values, const size_t count, const uint64_t base, const uint8_t width)
+{
+    size_t bit = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t v = values[i] - base;
+        uint8_t remaining = width;
+        while (remaining > 0) {
+            uint8_t shift = (uint8_t)(bit & 7);
+            uint8_t take = (uint8_t)(8 - shift);
+            if (take > remaining) {
+                take = remaining;
+            }
+
+            ret_buf[bit >> 3] = (char)((uint8_t)ret_buf[bit >> 3] | (uint8_t)((v & ((1u << take) - 1)) << shift));
+            v >>= take;
+            bit += take;
+            remaining = (uint8_t)(remaining - take);
+        }
+    }
+}
+
+/// @brief Unpacks count values written by prodVersionArchivePack.
+static inline void prodVersionArchiveUnpack(const char* buf, uint64_t* ret_values, const size_t count, const uint64_t base, const uint8_t width)
+{
+    size_t bit = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t v = 0;
+        uint8_t got = 0;
+        while (got < width) {
+            uint8_t shift = (uint8_t)(bit & 7);
+            uint8_t take = (uint8_t)(8 - shift);
+            if (take > width - got) {
+                take = (uint8_t)(width - got);
+            }
+
+            uint64_t bits = ((uint8_t)buf[bit >> 3] >> shift) & ((1u << take) - 1);
+            v |= bits << got;
+            bit += take;
+            got = (uint8_t)(got + take);
+        }
+        ret_values[i] = base + v;
+    }
+}
+
+/// @brief Compresses a block of encoded records.
+/// @note Records are archived in canonical form; bytes after a string terminator are not kept.
+/// @param work Scratch memory.
+/// @param records Back-to-back 64-byte encoded records.
+/// @param count Number of records, at most PRODVER_ARCHIVE_BLOCK_RECORDS.
+/// @param ret_buf Destination, PRODVER_ARCHIVE_MAX_LEN(count) bytes always suffice.
+/// @param len Length of ret_buf.
+/// @return Bytes written, or 0 on error (bad record, too many records, or buffer too small).
+static inline size_t prodVersionArchiveEncodeBlock(prodVersionArchiveWork_t* work, const char* records, const size_t count, char* ret_buf, const size_t len)
+{
+    if (!work || !records || !ret_buf || count == 0 || count > PRODVER_ARCHIVE_BLOCK_RECORDS) {
+        return 0;
+    }
+
+    for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+        prodVersionInternInit(&work->dicts[d], work->strings[d], PRODVER_ARCHIVE_BLOCK_RECORDS, work->slots[d], PRODVER_ARCHIVE_BLOCK_RECORDS * 2);
+    }
+
+    //  Split rows into columns
+    for (size_t i = 0; i < count; i++) {
+        const char* rec = records + i * PRODVER_ENCODED_LEN;
+        if ((uint8_t)rec[PRODVER_OFS_STRUCTVER] != PRODVER_STRUCTVER) {
+            return 0;
+        }
+
+        for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+            size_t offset;
+            size_t fieldLen;
+            prodVersionArchiveDictField(d, &offset, &fieldLen);
+            work->columns[d][i] = prodVersionIntern(&work->dicts[d], rec + offset, fieldLen);
+        }
+
+        work->columns[PRODVER_ARCHIVE_COL_MAJOR][i] = prodVersionArchiveReadBE(rec + PRODVER_OFS_MAJOR, 2);
+        work->columns[PRODVER_ARCHIVE_COL_MINOR][i] = prodVersionArchiveReadBE(rec + PRODVER_OFS_MINOR, 2);
+        work->columns[PRODVER_ARCHIVE_COL_PATCH][i] = prodVersionArchiveReadBE(rec + PRODVER_OFS_PATCH, 2);
+        work->columns[PRODVER_ARCHIVE_COL_BUILD][i] = prodVersionArchiveReadBE(rec + PRODVER_OFS_BUILD, 2);
+        work->columns[PRODVER_ARCHIVE_COL_CHANNEL][i] = (uint8_t)rec[PRODVER_OFS_CHANNEL];
+        work->columns[PRODVER_ARCHIVE_COL_DATE][i] = prodVersionPeekDate(rec);
+    }
+
+    if (len < PRODVER_ARCHIVE_HEADER_LEN) {
+        return 0;
+    }
+
+    size_t offset = 0;
+    ret_buf[offset++] = PRODVER_ARCHIVE_VER;
+    prodVersionArchiveWriteBE(ret_buf + offset, count, 4);
+    offset += 4;
+
+    //  Dictionaries
+    for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+        if (len - offset < 2) {
+            return 0;
+        }
+        prodVersionArchiveWriteBE(ret_buf + offset, work->dicts[d].count, 2);
+        offset += 2;
+
+        for (uint32_t id = 0; id < work->dicts[d].count; id++) {
+            const char* str = work->strings[d][id];
+            size_t slen = strlen(str);
+            if (len - offset < 1 + slen) {
+                return 0;
+            }
+            ret_buf[offset++] = (char)slen;
+            memcpy(ret_buf + offset, str, slen);
+            offset += slen;
+        }
+    }
+
+    //  Frame-of-reference columns
+    for (int c = 0; c < PRODVER_ARCHIVE_COLUMNS; c++) {
+        const uint64_t* values = work->columns[c];
+        uint64_t min = values[0];
+        uint64_t max = values[0];
+        for (size_t i = 1; i < count; i++) {
+            if (values[i] < min) min = values[i];
+            if (values[i] > max) max = values[i];
+        }
+
+        uint8_t width = 0;
+        for (uint64_t range = max - min; range; range >>= 1) {
+            width++;
+        }
+
+        size_t packed = prodVersionArchivePackedLen(count, width);
+        if (len - offset < 9 + packed) {
+            return 0;
+        }
+
+        prodVersionArchiveWriteBE(ret_buf + offset, min, 8);
+        ret_buf[offset + 8] = (char)width;
+        offset += 9;
+
+        memset(ret_buf + offset, 0, packed);
+        prodVersionArchivePack(ret_buf + offset, values, count, min, width);
+        offset += packed;
+    }
+
+    return offset;
+}
+
+/// @brief Decompresses a block back into 64-byte encoded records.
+/// @param work Scratch memory.
+/// @param buf Block from prodVersionArchiveEncodeBlock.
+/// @param len Length of buf.
+/// @param ret_records Destination for back-to-back encoded records.
+/// @param capacity Number of records ret_records can hold.
+/// @param ret_count Set to the number of records written.
+/// @return True on success, false if the block is malformed (including column values too wide for their field) or does not fit.
+static inline bool prodVersionArchiveDecodeBlock(prodVersionArchiveWork_t* work, const char* buf, const size_t len, char* ret_records, const size_t capacity, size_t* ret_count)
+{
+    if (ret_count) {
+        *ret_count = 0;
+    }
+
+    if (!work || !buf || !ret_records || len < PRODVER_ARCHIVE_HEADER_LEN || (uint8_t)buf[0] != PRODVER_ARCHIVE_VER) {
+        return false;
+    }
+
+    uint64_t count = prodVersionArchiveReadBE(buf + 1, 4);
+    if (count == 0 || count > PRODVER_ARCHIVE_BLOCK_RECORDS || count > capacity) {
+        return false;
+    }
+
+    size_t offset = PRODVER_ARCHIVE_HEADER_LEN;
+
+    //  Dictionaries, expanded into the work string table
+    uint32_t dictCount[PRODVER_ARCHIVE_DICTS];
+    for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+        if (len - offset < 2) {
+            return false;
+        }
+        dictCount[d] = (uint32_t)prodVersionArchiveReadBE(buf + offset, 2);
+        offset += 2;
+        if (dictCount[d] > count) {
+            return false;
+        }
+
+        size_t fieldOffset;
+        size_t fieldLen;
+        prodVersionArchiveDictField(d, &fieldOffset, &fieldLen);
+
+        for (uint32_t id = 0; id < dictCount[d]; id++) {
+            if (len - offset < 1) {
+                return false;
+            }
+            size_t slen = (uint8_t)buf[offset++];
+            if (slen > fieldLen || len - offset < slen) {
+                return false;
+            }
+            memset(work->strings[d][id], 0, sizeof(prodVersionInternStr_t));
+            memcpy(work->strings[d][id], buf + offset, slen);
+            offset += slen;
+        }
+    }
+
+    //  Columns
+    for (int c = 0; c < PRODVER_ARCHIVE_COLUMNS; c++) {
+        if (len - offset < 9) {
+            return false;
+        }
+        uint64_t base = prodVersionArchiveReadBE(buf + offset, 8);
+        uint8_t width = (uint8_t)buf[offset + 8];
+        offset += 9;
+
+        size_t packed = prodVersionArchivePackedLen((size_t)count, width);
+        if (width > 64 || len - offset < packed) {
+            return false;
+        }
+
+        prodVersionArchiveUnpack(buf + offset, work->columns[c], (size_t)count, base, width);
+        offset += packed;
+
+        //  Values must fit their field, or rows would be silently truncated
+        uint64_t limit = UINT64_MAX;
+        if (c >= PRODVER_ARCHIVE_COL_MAJOR && c <= PRODVER_ARCHIVE_COL_BUILD) {
+            limit = 0xFFFF;
+        } else if (c == PRODVER_ARCHIVE_COL_CHANNEL) {
+            limit = 0xFF;
+        }
+        for (size_t i = 0; i < count && limit != UINT64_MAX; i++) {
+            if (work->columns[c][i] > limit) {
+                return false;
+            }
+        }
+    }
+
+    //  Reassemble rows
+    for (size_t i = 0; i < count; i++) {
+        char* rec = ret_records + i * PRODVER_ENCODED_LEN;
+        memset(rec, 0, PRODVER_ENCODED_LEN);
+        rec[PRODVER_OFS_STRUCTVER] = PRODVER_STRUCTVER;
+
+        for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+            uint64_t id = work->columns[d][i];
+            if (id >= dictCount[d]) {
+                return false;
+            }
+
+            size_t fieldOffset;
+            size_t fieldLen;
+            prodVersionArchiveDictField(d, &fieldOffset, &fieldLen);
+            memcpy(rec + fieldOffset, work->strings[d][id], fieldLen);
+        }
+
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_MAJOR, work->columns[PRODVER_ARCHIVE_COL_MAJOR][i], 2);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_MINOR, work->columns[PRODVER_ARCHIVE_COL_MINOR][i], 2);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_PATCH, work->columns[PRODVER_ARCHIVE_COL_PATCH][i], 2);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_BUILD, work->columns[PRODVER_ARCHIVE_COL_BUILD][i], 2);
+        rec[PRODVER_OFS_CHANNEL] = (char)work->columns[PRODVER_ARCHIVE_COL_CHANNEL][i];
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_DATE, work->columns[PRODVER_ARCHIVE_COL_DATE][i], 8);
+    }
+
+    if (ret_count) {
+        *ret_count = (size_t)count;
+    }
+    return true;
+}
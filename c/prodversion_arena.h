@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+    Production Version - Arena Decoding
+    Nick Daria (contact@nickdaria.com)
+
+    Bump allocator over a caller-provided buffer for decoding batches of
+    versions without per-record heap allocations. Everything allocated is
+    released at once with prodVersionArenaReset.
+*/
+
+#include "prodversion.h"
+
+/// Alignment of arena allocations, covers the uint64_t in prodVersion_t
+#define PRODVER_ARENA_ALIGN           8
+
+typedef struct {
+    char* base;
+    size_t size;
+    size_t used;
+} prodVersionArena_t;
+
+/// @brief Initializes an arena over caller-provided memory.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionArenaInit(prodVersionArena_t* arena, void* mem, const size_t size)
+{
+    if (!arena || !mem) {
+        return false;
+    }
+
+    arena->base = (char*)mem;
+    arena->size = size;
+    arena->used = 0;
+    return true;
+}
+
+/// @brief Releases every allocation made from the arena.
+static inline void prodVersionArenaReset(prodVersionArena_t* arena)
+{
+    if (arena) {
+        arena->used = 0;
+    }
+}
+
+/// @brief Allocates aligned memory from the arena.
+/// @return Pointer to the allocation, or NULL if the arena is exhausted.
+static inline void* prodVersionArenaAlloc(prodVersionArena_t* arena, const size_t size)
+{
+    if (!arena) {
+        return NULL;
+    }
+
+    uintptr_t addr = (uintptr_t)(arena->base + arena->used);
+    size_t pad = (size_t)((PRODVER_ARENA_ALIGN - (addr % PRODVER_ARENA_ALIGN)) % PRODVER_ARENA_ALIGN);
+    if (pad > arena->size - arena->used || size > arena->size - arena->used - pad) {
+        return NULL;
+    }
+
+    void* ptr = arena->base + arena->used + pad;
+    arena->used += pad + size;
+    return ptr;
+}
+
+/// @brief Decodes a single encoded version into the arena.
+/// @param arena Arena to allocate from.
+/// @param buf Source data (must be at least 64 bytes).
+/// @param len Length of buf.
+/// @return Decoded version, or NULL on decode error or exhausted arena (nothing is allocated).
+static inline prodVersion_t* prodVersionArenaDecode(prodVersionArena_t* arena, const char* buf, const size_t len)
+{
+    if (!arena) {
+        return NULL;
+    }
+
+    size_t mark = arena->used;
+    prodVersion_t* version = (prodVersion_t*)prodVersionArenaAlloc(arena, sizeof(prodVersion_t));
+    if (!version) {
+        return NULL;
+    }
+
+    if (!prodVersionDecodeBytes(buf, len, version)) {
+        arena->used = mark;
+        return NULL;
+    }
+    return version;
+}
+
+/// @brief Decodes back-to-back encoded versions into one contiguous array in the arena.
+/// @param arena Arena to allocate from.
+/// @param buf Encoded records.
+/// @param len Length of buf, a trailing partial record is ignored.
+/// @param ret_count Set to the number of versions decoded.
+/// @return Array of ret_count versions, or NULL if any record fails to decode or the arena is exhausted (nothing is allocated).
+static inline prodVersion_t* prodVersionArenaDecodeBatch(prodVersionArena_t* arena, const char* buf, const size_t len, size_t* ret_count)
+{
+    if (ret_count) {
+        *ret_count = 0;
+    }
+
+    if (!arena || !buf) {
+        return NULL;
+    }
+
+    size_t count = len / PRODVER_ENCODED_LEN;
+    if (count > SIZE_MAX / sizeof(prodVersion_t)) {
+        return NULL;
+    }
+
+    size_t mark = arena->used;
+    prodVersion_t* versions = (prodVersion_t*)prodVersionArenaAlloc(arena, count * sizeof(prodVersion_t));
+    if (!versions) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!prodVersionDecodeBytes(buf + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &versions[i])) {
+            arena->used = mark;
+            return NULL;
+        }
+    }
+
+    if (ret_count) {
+        *ret_count = count;
+    }
+    return versions;
+}
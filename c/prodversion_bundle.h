@@ -0,0 +1,289 @@
+#pragma once
+
+/*
+    Production Version - Bill-of-Versions Bundle
+    Nick Daria (contact@nickdaria.com)
+
+    Packs the versions a device reports (hardware plus software components)
+    into one message. Products are split after their last space into a shared
+    prefix, stored once in a dictionary, and a per-component suffix, so
+    "ND SmartToaster FW" and "ND SmartToaster BLE" share "ND SmartToaster ".
+    All other fields are kept byte-for-byte as encoded bytes 25 - 63, which the
+    reader exposes in place without copying.
+
+    Layout:
+        [0]     PRODVER_BUNDLE_VER
+        [1]     Component count
+        [2]     Dictionary entry count
+                Dictionary entries: length (uint8), prefix characters
+                Components: dictionary index (uint8, PRODVER_BUNDLE_NO_PREFIX for none),
+                            suffix length (uint8), suffix characters,
+                            PRODVER_BUNDLE_TAIL_LEN bytes of the 64-byte encoding
+*/
+
+#include "prodversion.h"
+
+/// The current version of the bundle format
+#define PRODVER_BUNDLE_VER            1
+
+#define PRODVER_BUNDLE_HEADER_LEN     3
+#define PRODVER_BUNDLE_MAX_COMPONENTS 255
+#define PRODVER_BUNDLE_NO_PREFIX      0xFF
+
+/// Encoded bytes carried verbatim per component, major through date
+#define PRODVER_BUNDLE_TAIL_LEN       (PRODVER_ENCODED_LEN - PRODVER_OFS_MAJOR)
+
+/// Worst case bundle size for a given component count
+#define PRODVER_BUNDLE_MAX_LEN(count) (PRODVER_BUNDLE_HEADER_LEN + (count) * (2 * (PRODVER_FLD_PRODUCT_LEN + 1) + 2 + PRODVER_BUNDLE_TAIL_LEN))
+
+/// @brief Zero-copy view of one component, pointers reference the bundle buffer
+typedef struct {
+    const char* prefix;
+    uint8_t prefixLen;
+    const char* suffix;
+    uint8_t suffixLen;
+
+    /// @brief Encoded bytes PRODVER_OFS_MAJOR - 63 of the component
+    const char* tail;
+} prodVersionBundleComponent_t;
+
+typedef struct {
+    const char* buf;
+    size_t len;
+    uint8_t count;
+    uint8_t dictCount;
+
+    /// @brief Offset of each dictionary entry's length byte
+    uint16_t dict[PRODVER_BUNDLE_MAX_COMPONENTS];
+
+    /// @brief Offset of the first component
+    size_t components;
+} prodVersionBundleReader_t;
+
+static inline size_t prodVersionBundleFieldLen(const char* str, const size_t maxLen)
+{
+    size_t n = 0;
+    while (n < maxLen && str[n]) {
+        n++;
+    }
+    return n;
+}
+
+/// @brief Encodes a set of versions into a bundle.
+/// @param ret_buf Destination, PRODVER_BUNDLE_MAX_LEN(count) bytes always suffice.
+/// @param len Length of ret_buf.
+/// @param components Versions to bundle.
+/// @param count Number of versions, at most PRODVER_BUNDLE_MAX_COMPONENTS.
+/// @return Number of bytes written, or 0 on error.
+static inline size_t prodVersionBundleEncode(char* ret_buf, const size_t len, const prodVersion_t* components, const size_t count)
+{
+    if (!ret_buf || !components || count == 0 || count > PRODVER_BUNDLE_MAX_COMPONENTS || len < PRODVER_BUNDLE_HEADER_LEN) {
+        return 0;
+    }
+
+    //  Split every product and build the prefix dictionary
+    uint8_t prefixLen[PRODVER_BUNDLE_MAX_COMPONENTS];
+    uint8_t dictIndex[PRODVER_BUNDLE_MAX_COMPONENTS];
+    size_t dictOwner[PRODVER_BUNDLE_MAX_COMPONENTS];
+    uint8_t dictCount = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const char* product = components[i].product;
+        size_t plen = prodVersionBundleFieldLen(product, PRODVER_FLD_PRODUCT_LEN);
+
+        size_t split = 0;
+        for (size_t c = 0; c < plen; c++) {
+            if (product[c] == ' ') {
+                split = c + 1;
+            }
+        }
+        prefixLen[i] = (uint8_t)split;
+        dictIndex[i] = PRODVER_BUNDLE_NO_PREFIX;
+        if (split == 0) {
+            continue;
+        }
+
+        for (uint8_t d = 0; d < dictCount; d++) {
+            size_t owner = dictOwner[d];
+            if (prefixLen[owner] == split && memcmp(components[owner].product, product, split) == 0) {
+                dictIndex[i] = d;
+                break;
+            }
+        }
+        if (dictIndex[i] == PRODVER_BUNDLE_NO_PREFIX) {
+            dictOwner[dictCount] = i;
+            dictIndex[i] = dictCount++;
+        }
+    }
+
+    size_t offset = 0;
+    ret_buf[offset++] = PRODVER_BUNDLE_VER;
+    ret_buf[offset++] = (char)count;
+    ret_buf[offset++] = (char)dictCount;
+
+    //  Dictionary
+    for (uint8_t d = 0; d < dictCount; d++) {
+        size_t owner = dictOwner[d];
+        if (len - offset < 1u + prefixLen[owner]) {
+            return 0;
+        }
+        ret_buf[offset++] = (char)prefixLen[owner];
+        memcpy(ret_buf + offset, components[owner].product, prefixLen[owner]);
+        offset += prefixLen[owner];
+    }
+
+    //  Components
+    for (size_t i = 0; i < count; i++) {
+        char encoded[PRODVER_ENCODED_LEN];
+        if (!prodVersionEncodeBytes(encoded, sizeof(encoded), &components[i])) {
+            return 0;
+        }
+
+        size_t plen = prodVersionBundleFieldLen(components[i].product, PRODVER_FLD_PRODUCT_LEN);
+        size_t suffixLen = plen - prefixLen[i];
+        if (len - offset < 2 + suffixLen + PRODVER_BUNDLE_TAIL_LEN) {
+            return 0;
+        }
+
+        ret_buf[offset++] = (char)dictIndex[i];
+        ret_buf[offset++] = (char)suffixLen;
+        memcpy(ret_buf + offset, components[i].product + prefixLen[i], suffixLen);
+        offset += suffixLen;
+        memcpy(ret_buf + offset, encoded + PRODVER_OFS_MAJOR, PRODVER_BUNDLE_TAIL_LEN);
+        offset += PRODVER_BUNDLE_TAIL_LEN;
+    }
+
+    return offset;
+}
+
+/// @brief Validates a bundle and prepares it for reading. The buffer must outlive the reader.
+/// @return True on success, false if the bundle is malformed or truncated.
+static inline bool prodVersionBundleOpen(prodVersionBundleReader_t* reader, const char* buf, const size_t len)
+{
+    if (!reader || !buf || len < PRODVER_BUNDLE_HEADER_LEN || (uint8_t)buf[0] != PRODVER_BUNDLE_VER) {
+        return false;
+    }
+
+    reader->buf = buf;
+    reader->len = len;
+    reader->count = (uint8_t)buf[1];
+    reader->dictCount = (uint8_t)buf[2];
+
+    size_t offset = PRODVER_BUNDLE_HEADER_LEN;
+    for (uint8_t d = 0; d < reader->dictCount; d++) {
+        if (offset >= len) {
+            return false;
+        }
+        uint8_t plen = (uint8_t)buf[offset];
+        if (plen > PRODVER_FLD_PRODUCT_LEN || len - offset - 1 < plen) {
+            return false;
+        }
+        reader->dict[d] = (uint16_t)offset;
+        offset += 1u + plen;
+    }
+    reader->components = offset;
+
+    //  Walk the components once so reads never need bounds checks
+    for (uint8_t i = 0; i < reader->count; i++) {
+        if (len - offset < 2) {
+            return false;
+        }
+
+        uint8_t index = (uint8_t)buf[offset];
+        uint8_t suffixLen = (uint8_t)buf[offset + 1];
+        uint8_t prefixLen = 0;
+        if (index != PRODVER_BUNDLE_NO_PREFIX) {
+            if (index >= reader->dictCount) {
+                return false;
+            }
+            prefixLen = (uint8_t)buf[reader->dict[index]];
+        }
+
+        if (prefixLen + suffixLen > PRODVER_FLD_PRODUCT_LEN || len - offset - 2 < (size_t)suffixLen + PRODVER_BUNDLE_TAIL_LEN) {
+            return false;
+        }
+        offset += 2u + suffixLen + PRODVER_BUNDLE_TAIL_LEN;
+    }
+
+    return offset == len;
+}
+
+/// @brief Steps to the next component.
+/// @param reader Opened reader.
+/// @param io_offset Iterator state, start at 0.
+/// @param ret_component Set to a view of the component.
+/// @return True if a component was returned, false at the end.
+static inline bool prodVersionBundleNext(const prodVersionBundleReader_t* reader, size_t* io_offset, prodVersionBundleComponent_t* ret_component)
+{
+    if (!reader || !io_offset || !ret_component) {
+        return false;
+    }
+
+    size_t offset = (*io_offset == 0) ? reader->components : *io_offset;
+    if (offset >= reader->len) {
+        return false;
+    }
+
+    uint8_t index = (uint8_t)reader->buf[offset];
+    if (index == PRODVER_BUNDLE_NO_PREFIX) {
+        ret_component->prefix = NULL;
+        ret_component->prefixLen = 0;
+    } else {
+        ret_component->prefix = reader->buf + reader->dict[index] + 1;
+        ret_component->prefixLen = (uint8_t)reader->buf[reader->dict[index]];
+    }
+
+    ret_component->suffixLen = (uint8_t)reader->buf[offset + 1];
+    ret_component->suffix = reader->buf + offset + 2;
+    ret_component->tail = ret_component->suffix + ret_component->suffixLen;
+
+    *io_offset = offset + 2u + ret_component->suffixLen + PRODVER_BUNDLE_TAIL_LEN;
+    return true;
+}
+
+/// @brief Packed semantic version of a component, see prodVersionPeekSemver.
+static inline uint64_t prodVersionBundleSemver(const prodVersionBundleComponent_t* component)
+{
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) {
+        key = (key << 8) | (uint8_t)component->tail[i];
+    }
+    return key;
+}
+
+/// @brief Release channel of a component.
+static inline prodVersionChannel_t prodVersionBundleChannel(const prodVersionBundleComponent_t* component)
+{
+    return (prodVersionChannel_t)(uint8_t)component->tail[PRODVER_OFS_CHANNEL - PRODVER_OFS_MAJOR];
+}
+
+/// @brief Rebuilds the canonical 64-byte encoding of a component.
+/// @param ret_buf Destination (must be at least 64 bytes).
+/// @param len Length of ret_buf.
+/// @return Number of bytes written (64) or 0 on error.
+static inline size_t prodVersionBundleEncodeComponent(const prodVersionBundleComponent_t* component, char* ret_buf, const size_t len)
+{
+    if (!component || !ret_buf || len < PRODVER_ENCODED_LEN) {
+        return 0;
+    }
+
+    memset(ret_buf, 0, PRODVER_OFS_MAJOR);
+    ret_buf[PRODVER_OFS_STRUCTVER] = PRODVER_STRUCTVER;
+    if (component->prefixLen) {
+        memcpy(ret_buf + PRODVER_OFS_PRODUCT, component->prefix, component->prefixLen);
+    }
+    memcpy(ret_buf + PRODVER_OFS_PRODUCT + component->prefixLen, component->suffix, component->suffixLen);
+    memcpy(ret_buf + PRODVER_OFS_MAJOR, component->tail, PRODVER_BUNDLE_TAIL_LEN);
+    return PRODVER_ENCODED_LEN;
+}
+
+/// @brief Decodes a component into a version struct.
+/// @return True on success, false on error.
+static inline bool prodVersionBundleDecodeComponent(const prodVersionBundleComponent_t* component, prodVersion_t* ret_version)
+{
+    char encoded[PRODVER_ENCODED_LEN];
+    if (!prodVersionBundleEncodeComponent(component, encoded, sizeof(encoded))) {
+        return false;
+    }
+    return prodVersionDecodeBytes(encoded, sizeof(encoded), ret_version);
+}
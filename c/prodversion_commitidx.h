@@ -0,0 +1,153 @@
+#pragma once
+
+/*
+    Production Version - Commit Hash Index
+    Nick Daria (contact@nickdaria.com)
+
+    Secondary index from the 7-character commitHash (packed with
+    prodVersionPackCommit) to caller-defined record/device IDs. Entries are
+    appended, sorted once with prodVersionCommitIndexBuild, then queried by
+    binary search. Storage is caller-provided.
+*/
+
+#include <stdlib.h>
+
+#include "prodversion.h"
+
+typedef struct {
+    uint64_t commit;
+    uint64_t id;
+} prodVersionCommitEntry_t;
+
+typedef struct {
+    prodVersionCommitEntry_t* entries;
+    size_t capacity;
+    size_t count;
+
+    /// @brief True once built, cleared by any add
+    bool sorted;
+} prodVersionCommitIndex_t;
+
+/// @brief Initializes an empty index over caller-provided storage.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionCommitIndexInit(prodVersionCommitIndex_t* index, prodVersionCommitEntry_t* entries, const size_t capacity)
+{
+    if (!index || !entries || capacity == 0) {
+        return false;
+    }
+
+    index->entries = entries;
+    index->capacity = capacity;
+    index->count = 0;
+    index->sorted = true;
+    return true;
+}
+
+/// @brief Adds a record by its packed commit key.
+/// @return True on success, false if the index is full.
+static inline bool prodVersionCommitIndexAddKey(prodVersionCommitIndex_t* index, const uint64_t commit, const uint64_t id)
+{
+    if (!index || index->count >= index->capacity) {
+        return false;
+    }
+
+    index->entries[index->count].commit = commit;
+    index->entries[index->count].id = id;
+    index->count++;
+    index->sorted = false;
+    return true;
+}
+
+/// @brief Adds a decoded version under a caller-defined ID.
+/// @return True on success, false if the index is full.
+static inline bool prodVersionCommitIndexAdd(prodVersionCommitIndex_t* index, const prodVersion_t* version, const uint64_t id)
+{
+    if (!version) {
+        return false;
+    }
+    return prodVersionCommitIndexAddKey(index, prodVersionPackCommit(version->commitHash), id);
+}
+
+/// @brief Adds an encoded version under a caller-defined ID without decoding it.
+/// @param buf Encoded version (must be at least 64 bytes).
+/// @param len Length of buf.
+/// @return True on success, false if the index is full or the encoding is bad.
+static inline bool prodVersionCommitIndexAddBytes(prodVersionCommitIndex_t* index, const char* buf, const size_t len, const uint64_t id)
+{
+    if (!buf || len < PRODVER_ENCODED_LEN || (uint8_t)buf[PRODVER_OFS_STRUCTVER] != PRODVER_STRUCTVER) {
+        return false;
+    }
+    return prodVersionCommitIndexAddKey(index, prodVersionPackCommit(buf + PRODVER_OFS_COMMIT), id);
+}
+
+static inline int prodVersionCommitEntryCompare(const void* a, const void* b)
+{
+    const prodVersionCommitEntry_t* ea = (const prodVersionCommitEntry_t*)a;
+    const prodVersionCommitEntry_t* eb = (const prodVersionCommitEntry_t*)b;
+
+    if (ea->commit != eb->commit) return (ea->commit < eb->commit) ? -1 : 1;
+    if (ea->id != eb->id) return (ea->id < eb->id) ? -1 : 1;
+    return 0;
+}
+
+/// @brief Sorts the index so it can be queried. Call after adding and before finding.
+static inline void prodVersionCommitIndexBuild(prodVersionCommitIndex_t* index)
+{
+    if (!index || index->sorted) {
+        return;
+    }
+
+    qsort(index->entries, index->count, sizeof(prodVersionCommitEntry_t), prodVersionCommitEntryCompare);
+    index->sorted = true;
+}
+
+/// @brief Finds every record carrying a commit.
+/// @param index Built index.
+/// @param commitHash Commit hash to find.
+/// @param ret_count Set to the number of matching entries.
+/// @return First of ret_count contiguous entries, sorted by ID, or NULL if none or the index is not built.
+static inline const prodVersionCommitEntry_t* prodVersionCommitIndexFind(const prodVersionCommitIndex_t* index, const char* commitHash, size_t* ret_count)
+{
+    if (ret_count) {
+        *ret_count = 0;
+    }
+
+    if (!index || !commitHash || !index->sorted) {
+        return NULL;
+    }
+
+    uint64_t key = prodVersionPackCommit(commitHash);
+
+    //  Lower bound
+    size_t lo = 0;
+    size_t hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->entries[mid].commit < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t first = lo;
+
+    //  Upper bound
+    hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->entries[mid].commit <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == first) {
+        return NULL;
+    }
+
+    if (ret_count) {
+        *ret_count = lo - first;
+    }
+    return &index->entries[first];
+}
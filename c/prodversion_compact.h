@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+    Production Version - Compact Representation
+    Nick Daria (contact@nickdaria.com)
+
+    32-byte in-memory form of prodVersion_t for large resident caches, two per
+    64-byte cache line. Product and metadata become interned IDs and the date
+    becomes a 32-bit offset from a per-context base. Conversion is lossless for
+    canonical versions whose date falls within 2^32 seconds of the base.
+*/
+
+#include "prodversion_intern.h"
+
+typedef struct {
+    /// @brief major << 48 | minor << 32 | patch << 16 | build, orders like prodVersionCompare
+    uint64_t semver;
+
+    /// @brief releaseChannel << 56 | prodVersionPackCommit(commitHash)
+    uint64_t channelCommit;
+
+    /// @brief Interned product ID
+    uint32_t product;
+
+    /// @brief Interned metadata ID
+    uint32_t metadata;
+
+    /// @brief Seconds since prodVersionCompactCtx_t.dateBase
+    uint32_t dateDelta;
+
+    uint32_t reserved;
+} prodVersionCompact_t;
+
+//  Fails to compile if the compact form grows past 32 bytes
+typedef char prodVersionCompactSizeCheck_t[(sizeof(prodVersionCompact_t) == 32) ? 1 : -1];
+
+typedef struct {
+    prodVersionIntern_t products;
+    prodVersionIntern_t metadata;
+
+    /// @brief Earliest representable date, seconds since Unix epoch
+    uint64_t dateBase;
+} prodVersionCompactCtx_t;
+
+/// @brief Converts a version to its compact form, interning its strings.
+/// @param ctx Context holding the intern tables and date base.
+/// @param version Version to convert.
+/// @param ret_compact Destination.
+/// @return True on success, false if the date is out of range or an intern table is full.
+static inline bool prodVersionCompactPack(prodVersionCompactCtx_t* ctx, const prodVersion_t* version, prodVersionCompact_t* ret_compact)
+{
+    if (!ctx || !version || !ret_compact) {
+        return false;
+    }
+
+    if (version->date < ctx->dateBase || version->date - ctx->dateBase > UINT32_MAX) {
+        return false;
+    }
+
+    uint32_t product = prodVersionIntern(&ctx->products, version->product, PRODVER_FLD_PRODUCT_LEN);
+    uint32_t metadata = prodVersionIntern(&ctx->metadata, version->metadata, PRODVER_FLD_METADATA_LEN);
+    if (product == PRODVER_INTERN_NONE || metadata == PRODVER_INTERN_NONE) {
+        return false;
+    }
+
+    ret_compact->semver = prodVersionPackSemver(version);
+    ret_compact->channelCommit = ((uint64_t)(uint8_t)version->releaseChannel << 56) | prodVersionPackCommit(version->commitHash);
+    ret_compact->product = product;
+    ret_compact->metadata = metadata;
+    ret_compact->dateDelta = (uint32_t)(version->date - ctx->dateBase);
+    ret_compact->reserved = 0;
+    return true;
+}
+
+/// @brief Expands a compact version back to the full struct, in canonical form.
+/// @param ctx Context the version was packed with.
+/// @param compact Compact version.
+/// @param ret_version Destination.
+/// @return True on success, false if an interned ID is unknown.
+static inline bool prodVersionCompactUnpack(const prodVersionCompactCtx_t* ctx, const prodVersionCompact_t* compact, prodVersion_t* ret_version)
+{
+    if (!ctx || !compact || !ret_version) {
+        return false;
+    }
+
+    const char* product = prodVersionInternGet(&ctx->products, compact->product);
+    const char* metadata = prodVersionInternGet(&ctx->metadata, compact->metadata);
+    if (!product || !metadata) {
+        return false;
+    }
+
+    memset(ret_version, 0, sizeof(prodVersion_t));
+    prodVersionCopyField(ret_version->product, product, PRODVER_FLD_PRODUCT_LEN);
+    prodVersionCopyField(ret_version->metadata, metadata, PRODVER_FLD_METADATA_LEN);
+    prodVersionUnpackCommit(compact->channelCommit & 0x00FFFFFFFFFFFFFFull, ret_version->commitHash);
+
+    ret_version->major = (uint16_t)(compact->semver >> 48);
+    ret_version->minor = (uint16_t)(compact->semver >> 32);
+    ret_version->patch = (uint16_t)(compact->semver >> 16);
+    ret_version->build = (uint16_t)compact->semver;
+    ret_version->releaseChannel = (prodVersionChannel_t)(uint8_t)(compact->channelCommit >> 56);
+    ret_version->date = ctx->dateBase + compact->dateDelta;
+    return true;
+}
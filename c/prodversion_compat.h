@@ -0,0 +1,223 @@
+#pragma once
+
+/*
+    Production Version - Compatibility Matrix
+    Nick Daria (contact@nickdaria.com)
+
+    Rules allowing a range of software versions on a range of hardware
+    versions, per (software product, hardware product) pair. Rules are added,
+    built once, then queried with prodVersionCompatAllowed. Each pair's rules
+    form an implicit interval tree (sorted by software range start, augmented
+    with the subtree's highest end), so a query visits only the rules whose
+    software range covers it: O(log n + k) for k such rules. Hardware ranges
+    are not indexed, they are checked on each of those k rules, so a pair
+    with many rules overlapping in software but not in hardware (e.g. one
+    rule per board revision, all for software 1.x) degrades towards O(n)
+    per query. Anything no rule allows is denied. Storage is caller-provided.
+*/
+
+#include <stdlib.h>
+
+#include "prodversion_range.h"
+
+typedef struct {
+    char software[PRODVER_FLD_PRODUCT_LEN + 1];
+    char hardware[PRODVER_FLD_PRODUCT_LEN + 1];
+
+    /// @brief Inclusive bounds on prodVersionPackSemver keys
+    uint64_t swMin;
+    uint64_t swMax;
+    uint64_t hwMin;
+    uint64_t hwMax;
+
+    /// @brief Highest swMax in this rule's subtree, set by prodVersionCompatBuild
+    uint64_t subtreeMax;
+} prodVersionCompatRule_t;
+
+typedef struct {
+    prodVersionCompatRule_t* rules;
+    size_t capacity;
+    size_t count;
+
+    /// @brief True once built, cleared by any add
+    bool built;
+} prodVersionCompat_t;
+
+/// @brief Initializes an empty rule store over caller-provided storage.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionCompatInit(prodVersionCompat_t* compat, prodVersionCompatRule_t* rules, const size_t capacity)
+{
+    if (!compat || !rules || capacity == 0) {
+        return false;
+    }
+
+    compat->rules = rules;
+    compat->capacity = capacity;
+    compat->count = 0;
+    compat->built = true;
+    return true;
+}
+
+/// @brief Adds a rule from packed semver key bounds.
+/// @return True on success, false if the store is full or a range is empty.
+static inline bool prodVersionCompatAdd(prodVersionCompat_t* compat,
+                                        const char* software, const uint64_t swMin, const uint64_t swMax,
+                                        const char* hardware, const uint64_t hwMin, const uint64_t hwMax)
+{
+    if (!compat || !software || !hardware || compat->count >= compat->capacity || swMin > swMax || hwMin > hwMax) {
+        return false;
+    }
+
+    prodVersionCompatRule_t* rule = &compat->rules[compat->count++];
+    memset(rule, 0, sizeof(prodVersionCompatRule_t));
+    prodVersionCopyField(rule->software, software, PRODVER_FLD_PRODUCT_LEN);
+    prodVersionCopyField(rule->hardware, hardware, PRODVER_FLD_PRODUCT_LEN);
+    rule->swMin = swMin;
+    rule->swMax = swMax;
+    rule->hwMin = hwMin;
+    rule->hwMax = hwMax;
+    compat->built = false;
+    return true;
+}
+
+/// @brief Adds a rule from range expressions, e.g. (FW, ">=2.0 <3.0", Board, ">=1.1").
+/// @note Only the version terms of each expression are used.
+/// @return True on success, false on a syntax error, empty range or full store.
+static inline bool prodVersionCompatAddExpr(prodVersionCompat_t* compat,
+                                            const char* software, const char* swExpr,
+                                            const char* hardware, const char* hwExpr)
+{
+    prodVersionRange_t sw;
+    prodVersionRange_t hw;
+    if (!prodVersionRangeCompile(swExpr, &sw, NULL) || !prodVersionRangeCompile(hwExpr, &hw, NULL)) {
+        return false;
+    }
+    return prodVersionCompatAdd(compat, software, sw.minKey, sw.maxKey, hardware, hw.minKey, hw.maxKey);
+}
+
+/// @brief Orders rules by product pair.
+static inline int prodVersionCompatComparePair(const prodVersionCompatRule_t* rule, const char* software, const char* hardware)
+{
+    int cmp = strncmp(rule->software, software, PRODVER_FLD_PRODUCT_LEN);
+    return cmp ? cmp : strncmp(rule->hardware, hardware, PRODVER_FLD_PRODUCT_LEN);
+}
+
+static inline int prodVersionCompatRuleCompare(const void* a, const void* b)
+{
+    const prodVersionCompatRule_t* ra = (const prodVersionCompatRule_t*)a;
+    const prodVersionCompatRule_t* rb = (const prodVersionCompatRule_t*)b;
+
+    int cmp = prodVersionCompatComparePair(ra, rb->software, rb->hardware);
+    if (cmp) return cmp;
+    if (ra->swMin != rb->swMin) return (ra->swMin < rb->swMin) ? -1 : 1;
+    return 0;
+}
+
+/// @brief Fills subtreeMax for the implicit tree over rules [lo, hi), rooted at the midpoint.
+static inline uint64_t prodVersionCompatAugment(prodVersionCompatRule_t* rules, const size_t lo, const size_t hi)
+{
+    if (lo >= hi) {
+        return 0;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    uint64_t max = rules[mid].swMax;
+    uint64_t left = prodVersionCompatAugment(rules, lo, mid);
+    uint64_t right = prodVersionCompatAugment(rules, mid + 1, hi);
+    if (left > max) max = left;
+    if (right > max) max = right;
+
+    rules[mid].subtreeMax = max;
+    return max;
+}
+
+/// @brief Sorts rules and builds the per-pair interval trees. Call after adding and before querying.
+static inline void prodVersionCompatBuild(prodVersionCompat_t* compat)
+{
+    if (!compat || compat->built) {
+        return;
+    }
+
+    qsort(compat->rules, compat->count, sizeof(prodVersionCompatRule_t), prodVersionCompatRuleCompare);
+
+    size_t start = 0;
+    for (size_t i = 1; i <= compat->count; i++) {
+        if (i == compat->count || prodVersionCompatComparePair(&compat->rules[i], compat->rules[start].software, compat->rules[start].hardware) != 0) {
+            prodVersionCompatAugment(compat->rules, start, i);
+            start = i;
+        }
+    }
+
+    compat->built = true;
+}
+
+/// @brief Searches the implicit tree over rules [lo, hi) for one covering both keys.
+/// @note Only sw prunes the search; every rule whose software range covers sw may be visited
+/// before one also covering hw is found, so the worst case is linear in the pair's rule count.
+static inline bool prodVersionCompatStab(const prodVersionCompatRule_t* rules, size_t lo, size_t hi, const uint64_t sw, const uint64_t hw)
+{
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const prodVersionCompatRule_t* rule = &rules[mid];
+
+        //  Nothing in this subtree reaches sw
+        if (rule->subtreeMax < sw) {
+            return false;
+        }
+
+        if (prodVersionCompatStab(rules, lo, mid, sw, hw)) {
+            return true;
+        }
+
+        //  Rules right of mid start at or after this one
+        if (rule->swMin > sw) {
+            return false;
+        }
+
+        if (sw <= rule->swMax && hw >= rule->hwMin && hw <= rule->hwMax) {
+            return true;
+        }
+
+        lo = mid + 1;
+    }
+
+    return false;
+}
+
+/// @brief Checks if a software version may run on a hardware version.
+/// @param compat Built rule store.
+/// @param software Software version (e.g. candidate firmware).
+/// @param hardware Hardware version (e.g. read from EEPROM).
+/// @return True if a rule allows the combination, false otherwise or if the store is not built.
+static inline bool prodVersionCompatAllowed(const prodVersionCompat_t* compat, const prodVersion_t* software, const prodVersion_t* hardware)
+{
+    if (!compat || !software || !hardware || !compat->built) {
+        return false;
+    }
+
+    //  First rule of the pair
+    size_t lo = 0;
+    size_t hi = compat->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (prodVersionCompatComparePair(&compat->rules[mid], software->product, hardware->product) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t first = lo;
+
+    //  One past the last rule of the pair
+    hi = compat->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (prodVersionCompatComparePair(&compat->rules[mid], software->product, hardware->product) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return prodVersionCompatStab(compat->rules, first, lo, prodVersionPackSemver(software), prodVersionPackSemver(hardware));
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+/*
+    Production Version - Date Zone Map
+    Nick Daria (contact@nickdaria.com)
+
+    Block min/max statistics over the date field of a file of back-to-back
+    64-byte encoded records. Zones are appended as records are written, then
+    range queries skip every block whose [min, max] misses the range. Zone
+    storage is caller-provided and can be persisted next to the record file.
+*/
+
+#include "prodversion.h"
+
+/// Default records per block (64 KiB of encoded data)
+#define PRODVER_ZONE_RECORDS          1024
+
+typedef struct {
+    uint64_t minDate;
+    uint64_t maxDate;
+} prodVersionDateZone_t;
+
+typedef struct {
+    prodVersionDateZone_t* zones;
+    size_t capacity;
+
+    /// @brief Zones in use, the last may be partially filled
+    size_t count;
+
+    /// @brief Records per block
+    size_t blockRecords;
+
+    /// @brief Total records appended
+    uint64_t records;
+} prodVersionDateZoneMap_t;
+
+/// @brief Receives each record matched by a date range scan.
+/// @param buf Encoded record.
+/// @param index Position of the record in the file.
+/// @param ctx Caller context.
+/// @return False to stop scanning.
+typedef bool (*prodVersionDateZoneCallback_t)(const char* buf, uint64_t index, void* ctx);
+
+/// @brief Initializes an empty zone map over caller-provided storage.
+/// @param blockRecords Records per block, 0 for PRODVER_ZONE_RECORDS.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionDateZoneInit(prodVersionDateZoneMap_t* map, prodVersionDateZone_t* zones, const size_t capacity, const size_t blockRecords)
+{
+    if (!map || !zones || capacity == 0) {
+        return false;
+    }
+
+    map->zones = zones;
+    map->capacity = capacity;
+    map->count = 0;
+    map->blockRecords = blockRecords ? blockRecords : PRODVER_ZONE_RECORDS;
+    map->records = 0;
+    return true;
+}
+
+/// @brief Updates zone statistics for records as they are appended to the file.
+/// @param buf Encoded records, back-to-back.
+/// @param len Length of buf, a trailing partial record is ignored.
+/// @return Number of records accounted for, fewer than given if zone storage ran out.
+static inline size_t prodVersionDateZoneAppend(prodVersionDateZoneMap_t* map, const char* buf, const size_t len)
+{
+    if (!map || !buf) {
+        return 0;
+    }
+
+    size_t records = len / PRODVER_ENCODED_LEN;
+    for (size_t i = 0; i < records; i++) {
+        size_t slot = (size_t)(map->records % map->blockRecords);
+        if (slot == 0) {
+            if (map->count >= map->capacity) {
+                return i;
+            }
+            map->zones[map->count].minDate = UINT64_MAX;
+            map->zones[map->count].maxDate = 0;
+            map->count++;
+        }
+
+        uint64_t d = prodVersionPeekDate(buf + i * PRODVER_ENCODED_LEN);
+        prodVersionDateZone_t* zone = &map->zones[map->count - 1];
+        if (d < zone->minDate) zone->minDate = d;
+        if (d > zone->maxDate) zone->maxDate = d;
+        map->records++;
+    }
+
+    return records;
+}
+
+/// @brief Checks if a block may contain a date in [from, to].
+static inline bool prodVersionDateZoneOverlaps(const prodVersionDateZoneMap_t* map, const size_t block, const uint64_t from, const uint64_t to)
+{
+    const prodVersionDateZone_t* zone = &map->zones[block];
+    return zone->minDate <= to && zone->maxDate >= from;
+}
+
+/// @brief Scans records dated within [from, to], skipping blocks the zone map rules out.
+/// @note Use from = 0 for "built before to" queries, to = UINT64_MAX for "built after from".
+/// @param map Zone map describing buf.
+/// @param buf Records the map was built from (e.g. a memory-mapped file).
+/// @param len Length of buf.
+/// @param from First date to include.
+/// @param to Last date to include.
+/// @param callback Called for each matching record, in file order.
+/// @param ctx Passed to callback.
+/// @return Number of matching records visited.
+static inline uint64_t prodVersionDateZoneScan(const prodVersionDateZoneMap_t* map, const char* buf, const size_t len, const uint64_t from, const uint64_t to, prodVersionDateZoneCallback_t callback, void* ctx)
+{
+    if (!map || !buf || !callback || from > to) {
+        return 0;
+    }
+
+    uint64_t available = len / PRODVER_ENCODED_LEN;
+    if (available > map->records) {
+        available = map->records;
+    }
+
+    uint64_t matched = 0;
+    for (size_t block = 0; block < map->count; block++) {
+        if (!prodVersionDateZoneOverlaps(map, block, from, to)) {
+            continue;
+        }
+
+        uint64_t first = (uint64_t)block * map->blockRecords;
+        uint64_t end = first + map->blockRecords;
+        if (end > available) {
+            end = available;
+        }
+
+        for (uint64_t i = first; i < end; i++) {
+            const char* rec = buf + i * PRODVER_ENCODED_LEN;
+            uint64_t d = prodVersionPeekDate(rec);
+            if (d < from || d > to) {
+                continue;
+            }
+
+            matched++;
+            if (!callback(rec, i, ctx)) {
+                return matched;
+            }
+        }
+    }
+
+    return matched;
+}
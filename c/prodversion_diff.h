@@ -0,0 +1,163 @@
+#pragma once
+
+/*
+    Production Version - Fleet Diff
+    Nick Daria (contact@nickdaria.com)
+
+    Compares two inventory snapshots of (device ID, encoded version) pairs.
+    Both snapshots are sorted by device ID, then merge-joined in one linear
+    pass. Devices whose 64-byte encodings match are unchanged; otherwise the
+    packed semver keys decide upgrade or downgrade within the same product.
+    Encodings that differ only in bytes after a string terminator are treated
+    as equal, so snapshots need not be canonical.
+*/
+
+#include <stdlib.h>
+
+#include "prodversion.h"
+
+typedef struct {
+    uint64_t deviceId;
+    char encoded[PRODVER_ENCODED_LEN];
+} prodVersionFleetEntry_t;
+
+typedef enum {
+    PRODVER_DIFF_UNCHANGED = 0,
+
+    /// @brief Same product, higher version
+    PRODVER_DIFF_UPGRADED,
+
+    /// @brief Same product, lower version
+    PRODVER_DIFF_DOWNGRADED,
+
+    /// @brief Different product, or same version with other fields changed (commit, date, metadata, channel)
+    PRODVER_DIFF_CHANGED,
+
+    /// @brief Only in the new snapshot
+    PRODVER_DIFF_ADDED,
+
+    /// @brief Only in the old snapshot
+    PRODVER_DIFF_REMOVED,
+
+    PRODVER_DIFF_KINDS
+} prodVersionDiffKind_t;
+
+/// @brief Called per device that is not unchanged. before is NULL for added devices, after is NULL for removed.
+typedef void (*prodVersionDiffCallback_t)(uint64_t deviceId, prodVersionDiffKind_t kind, const char* before, const char* after, void* ctx);
+
+static inline int prodVersionFleetEntryCompare(const void* a, const void* b)
+{
+    uint64_t ia = ((const prodVersionFleetEntry_t*)a)->deviceId;
+    uint64_t ib = ((const prodVersionFleetEntry_t*)b)->deviceId;
+    return (ia > ib) - (ia < ib);
+}
+
+/// @brief Sorts a snapshot by device ID for prodVersionDiff.
+static inline void prodVersionFleetSort(prodVersionFleetEntry_t* entries, const size_t count)
+{
+    if (entries && count > 1) {
+        qsort(entries, count, sizeof(prodVersionFleetEntry_t), prodVersionFleetEntryCompare);
+    }
+}
+
+/// @brief Compares two encodings as eight 64-bit words without branching, so compilers emit vector compares.
+static inline bool prodVersionEncodedEqual(const char* a, const char* b)
+{
+    uint64_t diff = 0;
+    for (size_t i = 0; i < PRODVER_ENCODED_LEN; i += 8) {
+        uint64_t wa;
+        uint64_t wb;
+        memcpy(&wa, a + i, 8);
+        memcpy(&wb, b + i, 8);
+        diff |= wa ^ wb;
+    }
+    return diff == 0;
+}
+
+/// @brief Classifies a device present in both snapshots.
+static inline prodVersionDiffKind_t prodVersionDiffClassify(const char* before, const char* after)
+{
+    if (prodVersionEncodedEqual(before, after)) {
+        return PRODVER_DIFF_UNCHANGED;
+    }
+
+    //  Slow path, compare canonical copies so bytes after a terminator are ignored
+    char was[PRODVER_ENCODED_LEN];
+    char now[PRODVER_ENCODED_LEN];
+    memcpy(was, before, PRODVER_ENCODED_LEN);
+    memcpy(now, after, PRODVER_ENCODED_LEN);
+    prodVersionCanonicalizeBytes(was, PRODVER_ENCODED_LEN);
+    prodVersionCanonicalizeBytes(now, PRODVER_ENCODED_LEN);
+    if (prodVersionEncodedEqual(was, now)) {
+        return PRODVER_DIFF_UNCHANGED;
+    }
+
+    if (memcmp(was + PRODVER_OFS_PRODUCT, now + PRODVER_OFS_PRODUCT, PRODVER_FLD_PRODUCT_LEN) != 0) {
+        return PRODVER_DIFF_CHANGED;
+    }
+
+    uint64_t keyBefore = prodVersionPeekSemver(before);
+    uint64_t keyAfter = prodVersionPeekSemver(after);
+    if (keyAfter > keyBefore) {
+        return PRODVER_DIFF_UPGRADED;
+    }
+    if (keyAfter < keyBefore) {
+        return PRODVER_DIFF_DOWNGRADED;
+    }
+    return PRODVER_DIFF_CHANGED;
+}
+
+/// @brief Diffs two snapshots sorted with prodVersionFleetSort. Device IDs must be unique within a snapshot.
+/// @param before Older snapshot.
+/// @param beforeCount Entries in before.
+/// @param after Newer snapshot.
+/// @param afterCount Entries in after.
+/// @param ret_counts Optional, PRODVER_DIFF_KINDS counters indexed by prodVersionDiffKind_t, zeroed first.
+/// @param callback Optional, called for each device that is not unchanged.
+/// @param ctx Passed to callback.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionDiff(const prodVersionFleetEntry_t* before, const size_t beforeCount,
+                                   const prodVersionFleetEntry_t* after, const size_t afterCount,
+                                   uint64_t* ret_counts, prodVersionDiffCallback_t callback, void* ctx)
+{
+    if ((!before && beforeCount) || (!after && afterCount)) {
+        return false;
+    }
+
+    if (ret_counts) {
+        memset(ret_counts, 0, PRODVER_DIFF_KINDS * sizeof(uint64_t));
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < beforeCount || j < afterCount) {
+        prodVersionDiffKind_t kind;
+        uint64_t deviceId;
+        const char* was = NULL;
+        const char* now = NULL;
+
+        if (j == afterCount || (i < beforeCount && before[i].deviceId < after[j].deviceId)) {
+            kind = PRODVER_DIFF_REMOVED;
+            deviceId = before[i].deviceId;
+            was = before[i++].encoded;
+        } else if (i == beforeCount || after[j].deviceId < before[i].deviceId) {
+            kind = PRODVER_DIFF_ADDED;
+            deviceId = after[j].deviceId;
+            now = after[j++].encoded;
+        } else {
+            deviceId = before[i].deviceId;
+            was = before[i++].encoded;
+            now = after[j++].encoded;
+            kind = prodVersionDiffClassify(was, now);
+        }
+
+        if (ret_counts) {
+            ret_counts[kind]++;
+        }
+        if (callback && kind != PRODVER_DIFF_UNCHANGED) {
+            callback(deviceId, kind, was, now, ctx);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+/*
+    Production Version - Fleet Histogram
+    Nick Daria (contact@nickdaria.com)
+
+    Single-pass counts of versions grouped by product, by (major, minor), by
+    release channel and by build-date bucket. Each thread fills its own
+    histogram over its share of the data and the partials are combined with
+    prodVersionHistMerge. Bin storage is caller-provided.
+*/
+
+#include "prodversion.h"
+
+typedef struct {
+    /// @brief Group key, only meaningful when count is non-zero
+    uint64_t key;
+    uint64_t count;
+} prodVersionHistBin_t;
+
+typedef struct {
+    char product[PRODVER_FLD_PRODUCT_LEN + 1];
+    uint32_t hash;
+    uint64_t count;
+} prodVersionHistProduct_t;
+
+typedef struct {
+    prodVersionHistBin_t* bins;
+
+    /// @brief Number of bins, must be a power of two
+    size_t capacity;
+    size_t count;
+} prodVersionHistMap_t;
+
+typedef struct {
+    prodVersionHistProduct_t* products;
+    size_t productCapacity;
+    size_t productCount;
+
+    /// @brief Keyed by major << 16 | minor
+    prodVersionHistMap_t semver;
+
+    /// @brief Keyed by date / bucketSeconds
+    prodVersionHistMap_t dates;
+    uint64_t bucketSeconds;
+
+    /// @brief Indexed by channel character
+    uint64_t channels[256];
+
+    uint64_t total;
+} prodVersionHist_t;
+
+/// @brief Initializes an empty histogram over caller-provided bin storage.
+/// @param products Product bins, productCapacity must be a power of two.
+/// @param semverBins (major, minor) bins, semverCapacity must be a power of two.
+/// @param dateBins Date bucket bins, dateCapacity must be a power of two.
+/// @param bucketSeconds Width of a date bucket (e.g. 86400 for days).
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionHistInit(prodVersionHist_t* hist,
+                                       prodVersionHistProduct_t* products, const size_t productCapacity,
+                                       prodVersionHistBin_t* semverBins, const size_t semverCapacity,
+                                       prodVersionHistBin_t* dateBins, const size_t dateCapacity,
+                                       const uint64_t bucketSeconds)
+{
+    if (!hist || !products || !semverBins || !dateBins || bucketSeconds == 0 ||
+        productCapacity == 0 || (productCapacity & (productCapacity - 1)) != 0 ||
+        semverCapacity == 0 || (semverCapacity & (semverCapacity - 1)) != 0 ||
+        dateCapacity == 0 || (dateCapacity & (dateCapacity - 1)) != 0) {
+        return false;
+    }
+
+    memset(hist, 0, sizeof(prodVersionHist_t));
+    memset(products, 0, productCapacity * sizeof(prodVersionHistProduct_t));
+    memset(semverBins, 0, semverCapacity * sizeof(prodVersionHistBin_t));
+    memset(dateBins, 0, dateCapacity * sizeof(prodVersionHistBin_t));
+
+    hist->products = products;
+    hist->productCapacity = productCapacity;
+    hist->semver.bins = semverBins;
+    hist->semver.capacity = semverCapacity;
+    hist->dates.bins = dateBins;
+    hist->dates.capacity = dateCapacity;
+    hist->bucketSeconds = bucketSeconds;
+    return true;
+}
+
+/// @brief Adds to the count of an integer key.
+/// @return False if the key is new and the map is full.
+static inline bool prodVersionHistMapAdd(prodVersionHistMap_t* map, const uint64_t key, const uint64_t count)
+{
+    size_t mask = map->capacity - 1;
+    size_t i = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+
+    for (size_t probe = 0; probe < map->capacity; probe++, i = (i + 1) & mask) {
+        prodVersionHistBin_t* bin = &map->bins[i];
+        if (bin->count == 0) {
+            bin->key = key;
+            bin->count = count;
+            map->count++;
+            return true;
+        }
+        if (bin->key == key) {
+            bin->count += count;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// @brief Adds to the count of a product.
+/// @return False if the product is new and the table is full.
+static inline bool prodVersionHistProductAdd(prodVersionHist_t* hist, const char* product, const uint64_t count)
+{
+    uint32_t hash = prodVersionHashString(product, PRODVER_FLD_PRODUCT_LEN);
+    size_t mask = hist->productCapacity - 1;
+    size_t i = hash & mask;
+
+    for (size_t probe = 0; probe < hist->productCapacity; probe++, i = (i + 1) & mask) {
+        prodVersionHistProduct_t* bin = &hist->products[i];
+        if (bin->count == 0) {
+            memset(bin->product, 0, sizeof(bin->product));
+            prodVersionCopyField(bin->product, product, PRODVER_FLD_PRODUCT_LEN);
+            bin->hash = hash;
+            bin->count = count;
+            hist->productCount++;
+            return true;
+        }
+        if (bin->hash == hash && strncmp(bin->product, product, PRODVER_FLD_PRODUCT_LEN) == 0) {
+            bin->count += count;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// @brief Counts one version in every grouping.
+/// @return False if a grouping ran out of bins; counts already added are kept.
+static inline bool prodVersionHistAdd(prodVersionHist_t* hist, const prodVersion_t* version)
+{
+    if (!hist || !version) {
+        return false;
+    }
+
+    hist->total++;
+    hist->channels[(uint8_t)version->releaseChannel]++;
+
+    bool ok = prodVersionHistProductAdd(hist, version->product, 1);
+    ok &= prodVersionHistMapAdd(&hist->semver, ((uint64_t)version->major << 16) | version->minor, 1);
+    ok &= prodVersionHistMapAdd(&hist->dates, version->date / hist->bucketSeconds, 1);
+    return ok;
+}
+
+/// @brief Counts back-to-back encoded versions straight from their encoding, without decoding.
+/// @param buf Encoded records.
+/// @param len Length of buf, a trailing partial record is ignored.
+/// @return False if a grouping ran out of bins; records with a bad structure version are skipped.
+static inline bool prodVersionHistAddBytes(prodVersionHist_t* hist, const char* buf, const size_t len)
+{
+    if (!hist || !buf) {
+        return false;
+    }
+
+    bool ok = true;
+    size_t records = len / PRODVER_ENCODED_LEN;
+    for (size_t r = 0; r < records; r++) {
+        const char* rec = buf + r * PRODVER_ENCODED_LEN;
+        if ((uint8_t)rec[PRODVER_OFS_STRUCTVER] != PRODVER_STRUCTVER) {
+            continue;
+        }
+
+        //  Major and minor are adjacent big-endian uint16s, so the 4 bytes read as one key
+        uint64_t semver = 0;
+        for (int i = 0; i < 4; i++) {
+            semver = (semver << 8) | (uint8_t)rec[PRODVER_OFS_MAJOR + i];
+        }
+
+        hist->total++;
+        hist->channels[(uint8_t)rec[PRODVER_OFS_CHANNEL]]++;
+        ok &= prodVersionHistProductAdd(hist, rec + PRODVER_OFS_PRODUCT, 1);
+        ok &= prodVersionHistMapAdd(&hist->semver, semver, 1);
+        ok &= prodVersionHistMapAdd(&hist->dates, prodVersionPeekDate(rec) / hist->bucketSeconds, 1);
+    }
+
+    return ok;
+}
+
+/// @brief Merges a partial histogram (e.g. from another thread) into dst.
+/// @note Both must use the same bucketSeconds.
+/// @return False if dst ran out of bins or the bucket widths differ.
+static inline bool prodVersionHistMerge(prodVersionHist_t* dst, const prodVersionHist_t* src)
+{
+    if (!dst || !src || dst->bucketSeconds != src->bucketSeconds) {
+        return false;
+    }
+
+    bool ok = true;
+    dst->total += src->total;
+    for (size_t i = 0; i < 256; i++) {
+        dst->channels[i] += src->channels[i];
+    }
+
+    for (size_t i = 0; i < src->productCapacity; i++) {
+        if (src->products[i].count) {
+            ok &= prodVersionHistProductAdd(dst, src->products[i].product, src->products[i].count);
+        }
+    }
+    for (size_t i = 0; i < src->semver.capacity; i++) {
+        if (src->semver.bins[i].count) {
+            ok &= prodVersionHistMapAdd(&dst->semver, src->semver.bins[i].key, src->semver.bins[i].count);
+        }
+    }
+    for (size_t i = 0; i < src->dates.capacity; i++) {
+        if (src->dates.bins[i].count) {
+            ok &= prodVersionHistMapAdd(&dst->dates, src->dates.bins[i].key, src->dates.bins[i].count);
+        }
+    }
+
+    return ok;
+}
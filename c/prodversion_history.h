@@ -0,0 +1,419 @@
+#pragma once
+
+/*
+    Production Version - Device History
+    Nick Daria (contact@nickdaria.com)
+
+    Stores each device's sequence of version reports for time-travel queries.
+    Reports are appended in batches (e.g. telemetry logs as they arrive). Each
+    batch is sorted by (device, time) and merged into the entry index from the
+    back, so existing entries move at most once per batch. Each report is
+    stored as a delta against the device's previous report, a mask of changed
+    8-byte words followed by those words, in an append-only delta stream.
+    Every PRODVER_HISTORY_KEYFRAME reports per device the delta is taken against
+    zero, bounding how far a lookup walks back. Stints (consecutive reports of
+    the same version) are indexed by (device, start) and merged the same way, so
+    leave times are found by binary search. Encodings are canonicalized first,
+    so bytes after a string terminator never split a stint. Storage is
+    caller-provided.
+
+    Queries:
+        prodVersionHistoryAt        Version a device was running at a time
+        prodVersionHistoryLeft      When a device stopped running a version
+*/
+
+#include <stdlib.h>
+
+#include "prodversion.h"
+
+/// @brief Reports between full (delta against zero) entries per device
+#define PRODVER_HISTORY_KEYFRAME      16
+
+/// @brief Worst-case delta bytes per report (mask plus all words)
+#define PRODVER_HISTORY_DELTA_MAX     (1 + PRODVER_ENCODED_LEN)
+
+#define PRODVER_HISTORY_WORDS         (PRODVER_ENCODED_LEN / 8)
+
+/// @brief Input report, canonicalized and sorted in place by prodVersionHistoryAppend
+typedef struct {
+    uint64_t deviceId;
+    uint64_t time;
+    char encoded[PRODVER_ENCODED_LEN];
+} prodVersionReport_t;
+
+typedef struct {
+    uint64_t deviceId;
+    uint64_t time;
+
+    /// @brief Offset of this report's delta in the delta stream
+    uint32_t offset;
+
+    /// @brief Reports back to this device's last keyframe (0 for a keyframe)
+    uint16_t sinceKey;
+} prodVersionHistoryEntry_t;
+
+typedef struct {
+    uint64_t deviceId;
+
+    /// @brief prodVersionHistoryHash of the encoding held during the stint
+    uint64_t hash;
+
+    /// @brief First report of the stint
+    uint64_t startTime;
+
+    /// @brief Time of the first report with a different encoding, UINT64_MAX if still running
+    uint64_t leaveTime;
+} prodVersionHistoryStint_t;
+
+typedef struct {
+    prodVersionHistoryEntry_t* entries;
+    size_t entryCapacity;
+    size_t count;
+
+    uint8_t* deltas;
+    size_t deltaCapacity;
+    size_t deltaLen;
+
+    prodVersionHistoryStint_t* stints;
+    size_t stintCapacity;
+    size_t stintCount;
+} prodVersionHistory_t;
+
+/// @brief Initializes an empty history over caller-provided storage.
+/// @note For n reports in total, n entries, n stints and n * PRODVER_HISTORY_DELTA_MAX delta bytes always suffice.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionHistoryInit(prodVersionHistory_t* history,
+                                          prodVersionHistoryEntry_t* entries, const size_t entryCapacity,
+                                          uint8_t* deltas, const size_t deltaCapacity,
+                                          prodVersionHistoryStint_t* stints, const size_t stintCapacity)
+{
+    if (!history || !entries || !deltas || !stints || entryCapacity > UINT32_MAX || deltaCapacity > UINT32_MAX) {
+        return false;
+    }
+
+    history->entries = entries;
+    history->entryCapacity = entryCapacity;
+    history->count = 0;
+    history->deltas = deltas;
+    history->deltaCapacity = deltaCapacity;
+    history->deltaLen = 0;
+    history->stints = stints;
+    history->stintCapacity = stintCapacity;
+    history->stintCount = 0;
+    return true;
+}
+
+/// @brief FNV-1a over a full encoding, identifying a version for stint lookups.
+static inline uint64_t prodVersionHistoryHash(const char* encoded)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < PRODVER_ENCODED_LEN; i++) {
+        hash ^= (uint8_t)encoded[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static inline int prodVersionReportCompare(const void* a, const void* b)
+{
+    const prodVersionReport_t* ra = (const prodVersionReport_t*)a;
+    const prodVersionReport_t* rb = (const prodVersionReport_t*)b;
+
+    if (ra->deviceId != rb->deviceId) return (ra->deviceId < rb->deviceId) ? -1 : 1;
+    if (ra->time != rb->time) return (ra->time < rb->time) ? -1 : 1;
+    return 0;
+}
+
+/// @brief Appends the delta from base to encoded.
+static inline void prodVersionHistoryPutDelta(prodVersionHistory_t* history, const char* base, const char* encoded)
+{
+    uint8_t* out = history->deltas + history->deltaLen;
+    uint8_t mask = 0;
+    size_t len = 1;
+
+    for (int w = 0; w < PRODVER_HISTORY_WORDS; w++) {
+        if (memcmp(base + w * 8, encoded + w * 8, 8) != 0) {
+            mask |= (uint8_t)(1u << w);
+            memcpy(out + len, encoded + w * 8, 8);
+            len += 8;
+        }
+    }
+
+    out[0] = mask;
+    history->deltaLen += len;
+}
+
+/// @brief Applies the delta at offset onto ret_encoded.
+static inline void prodVersionHistoryApplyDelta(const prodVersionHistory_t* history, const uint32_t offset, char* ret_encoded)
+{
+    const uint8_t* in = history->deltas + offset;
+    uint8_t mask = *in++;
+
+    for (int w = 0; w < PRODVER_HISTORY_WORDS; w++) {
+        if (mask & (1u << w)) {
+            memcpy(ret_encoded + w * 8, in, 8);
+            in += 8;
+        }
+    }
+}
+
+/// @brief Reconstructs the encoding of an entry by walking forward from its keyframe.
+static inline void prodVersionHistoryReconstruct(const prodVersionHistory_t* history, const size_t index, char* ret_encoded)
+{
+    memset(ret_encoded, 0, PRODVER_ENCODED_LEN);
+    for (size_t i = index - history->entries[index].sinceKey; i <= index; i++) {
+        prodVersionHistoryApplyDelta(history, history->entries[i].offset, ret_encoded);
+    }
+}
+
+/// @brief Index of the first entry after (deviceId, time).
+static inline size_t prodVersionHistoryUpperBound(const prodVersionHistory_t* history, const uint64_t deviceId, const uint64_t time)
+{
+    size_t lo = 0;
+    size_t hi = history->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const prodVersionHistoryEntry_t* entry = &history->entries[mid];
+        if (entry->deviceId < deviceId || (entry->deviceId == deviceId && entry->time <= time)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/// @brief Index of a device's last stored entry plus one, and its encoding, or 0 if the device has none.
+static inline size_t prodVersionHistoryLastOf(const prodVersionHistory_t* history, const uint64_t deviceId, char* ret_encoded)
+{
+    size_t end = prodVersionHistoryUpperBound(history, deviceId, UINT64_MAX);
+    if (end == 0 || history->entries[end - 1].deviceId != deviceId) {
+        return 0;
+    }
+
+    prodVersionHistoryReconstruct(history, end - 1, ret_encoded);
+    return end;
+}
+
+/// @brief Appends a batch of reports to the history.
+/// @note The batch is applied whole or not at all. Each device's reports must not predate its latest stored
+/// report. Needs room for count more entries and stints and count * PRODVER_HISTORY_DELTA_MAX delta bytes.
+/// Costs one pass over the stored entries and stints plus sorting the batch.
+/// @param history Initialized history.
+/// @param reports Reports, canonicalized and sorted in place by (device, time).
+/// @param count Number of reports.
+/// @return True on success, false on a bad encoding, a report older than its device's history, or too little storage.
+static inline bool prodVersionHistoryAppend(prodVersionHistory_t* history, prodVersionReport_t* reports, const size_t count)
+{
+    if (!history || (!reports && count)) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    if (count > history->entryCapacity - history->count || count > history->stintCapacity - history->stintCount ||
+        count > (history->deltaCapacity - history->deltaLen) / PRODVER_HISTORY_DELTA_MAX ||
+        history->deltaLen + count * PRODVER_HISTORY_DELTA_MAX > UINT32_MAX) {
+        return false;
+    }
+
+    for (size_t r = 0; r < count; r++) {
+        if (!prodVersionCanonicalizeBytes(reports[r].encoded, PRODVER_ENCODED_LEN)) {
+            return false;
+        }
+    }
+    qsort(reports, count, sizeof(prodVersionReport_t), prodVersionReportCompare);
+
+    //  Validate order and count the stints the batch starts, before anything is modified
+    char last[PRODVER_ENCODED_LEN];
+    size_t newStints = 0;
+    for (size_t r = 0; r < count; r++) {
+        const prodVersionReport_t* report = &reports[r];
+        if (r > 0 && reports[r - 1].deviceId == report->deviceId) {
+            newStints += memcmp(reports[r - 1].encoded, report->encoded, PRODVER_ENCODED_LEN) != 0;
+            continue;
+        }
+
+        size_t end = prodVersionHistoryLastOf(history, report->deviceId, last);
+        if (end && history->entries[end - 1].time > report->time) {
+            return false;
+        }
+        newStints += !end || memcmp(last, report->encoded, PRODVER_ENCODED_LEN) != 0;
+    }
+
+    //  Stints, merged from the back. A device's new stints follow its stored ones, and the first closes its open stint.
+    size_t i = history->stintCount;
+    size_t k = history->stintCount + newStints;
+    size_t r = count;
+    while (r > 0) {
+        uint64_t deviceId = reports[r - 1].deviceId;
+        while (i > 0 && history->stints[i - 1].deviceId > deviceId) {
+            history->stints[--k] = history->stints[--i];
+        }
+
+        size_t first = r - 1;
+        while (first > 0 && reports[first - 1].deviceId == deviceId) {
+            first--;
+        }
+        size_t end = prodVersionHistoryLastOf(history, deviceId, last);
+
+        uint64_t leaveTime = UINT64_MAX;
+        for (; r > first; r--) {
+            const prodVersionReport_t* report = &reports[r - 1];
+            const char* prev = (r - 1 > first) ? reports[r - 2].encoded : (end ? last : NULL);
+            if (prev && memcmp(prev, report->encoded, PRODVER_ENCODED_LEN) == 0) {
+                continue;
+            }
+
+            prodVersionHistoryStint_t* stint = &history->stints[--k];
+            stint->deviceId = deviceId;
+            stint->hash = prodVersionHistoryHash(report->encoded);
+            stint->startTime = report->time;
+            stint->leaveTime = leaveTime;
+            leaveTime = report->time;
+        }
+
+        if (leaveTime != UINT64_MAX && i > 0 && history->stints[i - 1].deviceId == deviceId) {
+            history->stints[i - 1].leaveTime = leaveTime;
+        }
+    }
+    history->stintCount += newStints;
+
+    //  Entries, merged from the back. Entries at or before i are untouched, so a device's chain can still be walked.
+    static const char zero[PRODVER_ENCODED_LEN] = { 0 };
+    i = history->count;
+    k = history->count + count;
+    r = count;
+    while (r > 0) {
+        uint64_t deviceId = reports[r - 1].deviceId;
+        while (i > 0 && history->entries[i - 1].deviceId > deviceId) {
+            history->entries[--k] = history->entries[--i];
+        }
+
+        size_t first = r - 1;
+        while (first > 0 && reports[first - 1].deviceId == deviceId) {
+            first--;
+        }
+
+        //  Continue the device's keyframe cadence from its last stored entry
+        bool stored = i > 0 && history->entries[i - 1].deviceId == deviceId;
+        uint16_t baseSince = PRODVER_HISTORY_KEYFRAME - 1;
+        if (stored) {
+            baseSince = history->entries[i - 1].sinceKey;
+            prodVersionHistoryReconstruct(history, i - 1, last);
+        }
+
+        for (; r > first; r--) {
+            const prodVersionReport_t* report = &reports[r - 1];
+            uint16_t sinceKey = (uint16_t)((baseSince + (r - first)) % PRODVER_HISTORY_KEYFRAME);
+            const char* base = !sinceKey ? zero : ((r - 1 > first) ? reports[r - 2].encoded : last);
+
+            prodVersionHistoryEntry_t* entry = &history->entries[--k];
+            entry->deviceId = deviceId;
+            entry->time = report->time;
+            entry->offset = (uint32_t)history->deltaLen;
+            entry->sinceKey = sinceKey;
+            prodVersionHistoryPutDelta(history, base, report->encoded);
+        }
+    }
+    history->count += count;
+
+    return true;
+}
+
+/// @brief Builds the history from a batch of reports, replacing any previous contents.
+/// @param history Initialized history.
+/// @param reports Reports, canonicalized and sorted in place by (device, time).
+/// @param count Number of reports.
+/// @return True on success, false on a bad encoding or if storage is too small.
+static inline bool prodVersionHistoryBuild(prodVersionHistory_t* history, prodVersionReport_t* reports, const size_t count)
+{
+    if (!history) {
+        return false;
+    }
+
+    history->count = 0;
+    history->deltaLen = 0;
+    history->stintCount = 0;
+    return prodVersionHistoryAppend(history, reports, count);
+}
+
+/// @brief Finds the version a device was running at a time (its last report at or before it).
+/// @param history Built history.
+/// @param deviceId Device.
+/// @param time Point in time.
+/// @param ret_encoded Destination for the 64-byte encoding, in canonical form.
+/// @param ret_reportTime Optional, time of the report found.
+/// @return True if found, false if the device has no report at or before time.
+static inline bool prodVersionHistoryAt(const prodVersionHistory_t* history, const uint64_t deviceId, const uint64_t time, char* ret_encoded, uint64_t* ret_reportTime)
+{
+    if (!history || !ret_encoded) {
+        return false;
+    }
+
+    size_t lo = prodVersionHistoryUpperBound(history, deviceId, time);
+    if (lo == 0 || history->entries[lo - 1].deviceId != deviceId) {
+        return false;
+    }
+
+    prodVersionHistoryReconstruct(history, lo - 1, ret_encoded);
+    if (ret_reportTime) {
+        *ret_reportTime = history->entries[lo - 1].time;
+    }
+    return true;
+}
+
+/// @brief Finds when a device stopped running a version.
+/// @param history Built history.
+/// @param deviceId Device.
+/// @param encoded 64-byte encoding of the version, compared in canonical form.
+/// @param since Only consider stints still running after this time (0 for the first stint).
+/// @param ret_leaveTime Time of the first report with another version, UINT64_MAX if the device still runs it.
+/// @return True if a matching stint was found, false if the device never ran the version after since.
+static inline bool prodVersionHistoryLeft(const prodVersionHistory_t* history, const uint64_t deviceId, const char* encoded, const uint64_t since, uint64_t* ret_leaveTime)
+{
+    if (!history || !encoded || !ret_leaveTime) {
+        return false;
+    }
+
+    char canonical[PRODVER_ENCODED_LEN];
+    memcpy(canonical, encoded, PRODVER_ENCODED_LEN);
+    if (!prodVersionCanonicalizeBytes(canonical, PRODVER_ENCODED_LEN)) {
+        return false;
+    }
+    uint64_t hash = prodVersionHistoryHash(canonical);
+
+    //  A device's stints are disjoint and sorted by start, so leave times ascend too
+    size_t lo = 0;
+    size_t hi = history->stintCount;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const prodVersionHistoryStint_t* stint = &history->stints[mid];
+        if (stint->deviceId < deviceId || (stint->deviceId == deviceId && stint->leaveTime <= since)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    //  First later stint of the version, confirming the encoding at its first report to skip hash collisions
+    char check[PRODVER_ENCODED_LEN];
+    for (; lo < history->stintCount && history->stints[lo].deviceId == deviceId; lo++) {
+        const prodVersionHistoryStint_t* stint = &history->stints[lo];
+        if (stint->hash != hash) {
+            continue;
+        }
+
+        size_t entry = prodVersionHistoryUpperBound(history, deviceId, stint->startTime);
+        while (entry > 0 && history->entries[entry - 1].deviceId == deviceId && history->entries[entry - 1].time == stint->startTime) {
+            prodVersionHistoryReconstruct(history, --entry, check);
+            if (memcmp(check, canonical, PRODVER_ENCODED_LEN) == 0) {
+                *ret_leaveTime = stint->leaveTime;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
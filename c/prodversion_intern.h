@@ -0,0 +1,125 @@
+#pragma once
+
+/*
+    Production Version - String Interning
+    Nick Daria (contact@nickdaria.com)
+
+    Maps product/metadata strings to dense 32-bit IDs and back. Storage is
+    caller-provided: one fixed-width string slot per ID plus a power-of-two
+    open-addressed hash index.
+*/
+
+#include "prodversion.h"
+
+/// Longest string field in prodVersion_t, every interned string fits in one slot
+#define PRODVER_INTERN_STR_LEN        PRODVER_FLD_PRODUCT_LEN
+
+/// Returned by lookups that find nothing
+#define PRODVER_INTERN_NONE           UINT32_MAX
+
+typedef char prodVersionInternStr_t[PRODVER_INTERN_STR_LEN + 1];
+
+typedef struct {
+    /// @brief String for each ID
+    prodVersionInternStr_t* strings;
+    size_t capacity;
+
+    /// @brief Hash index holding ID + 1 per slot, 0 when empty
+    uint32_t* slots;
+    size_t slotCount;
+
+    uint32_t count;
+} prodVersionIntern_t;
+
+/// @brief Initializes an empty table over caller-provided storage.
+/// @param table Table to initialize.
+/// @param strings String storage, one per ID.
+/// @param capacity Number of strings.
+/// @param slots Hash index storage.
+/// @param slotCount Number of hash slots, a power of two greater than capacity.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionInternInit(prodVersionIntern_t* table, prodVersionInternStr_t* strings, const size_t capacity, uint32_t* slots, const size_t slotCount)
+{
+    if (!table || !strings || !slots || capacity == 0 || capacity >= PRODVER_INTERN_NONE ||
+        slotCount <= capacity || (slotCount & (slotCount - 1)) != 0) {
+        return false;
+    }
+
+    memset(slots, 0, slotCount * sizeof(uint32_t));
+    table->strings = strings;
+    table->capacity = capacity;
+    table->slots = slots;
+    table->slotCount = slotCount;
+    table->count = 0;
+    return true;
+}
+
+/// @brief Finds the hash slot for a string, or the empty slot it would occupy.
+static inline uint32_t* prodVersionInternSlot(const prodVersionIntern_t* table, const char* str, const size_t maxLen)
+{
+    size_t mask = table->slotCount - 1;
+    size_t i = prodVersionHashString(str, maxLen) & mask;
+
+    //  slotCount > capacity guarantees an empty slot terminates the probe
+    for (;;) {
+        uint32_t* slot = &table->slots[i];
+        if (*slot == 0) {
+            return slot;
+        }
+
+        //  Stored strings may be longer than maxLen, so a prefix match is not enough
+        const char* stored = table->strings[*slot - 1];
+        if (strncmp(stored, str, maxLen) == 0 && stored[maxLen] == '\0') {
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+/// @brief Looks up the ID of a string without adding it.
+/// @param maxLen Length of the source field, at most PRODVER_INTERN_STR_LEN.
+/// @return ID, or PRODVER_INTERN_NONE if not interned.
+static inline uint32_t prodVersionInternFind(const prodVersionIntern_t* table, const char* str, const size_t maxLen)
+{
+    if (!table || !str || maxLen > PRODVER_INTERN_STR_LEN) {
+        return PRODVER_INTERN_NONE;
+    }
+
+    uint32_t* slot = prodVersionInternSlot(table, str, maxLen);
+    return (*slot == 0) ? PRODVER_INTERN_NONE : *slot - 1;
+}
+
+/// @brief Returns the ID of a string, adding it if new.
+/// @param maxLen Length of the source field, at most PRODVER_INTERN_STR_LEN.
+/// @return ID, or PRODVER_INTERN_NONE if the table is full.
+static inline uint32_t prodVersionIntern(prodVersionIntern_t* table, const char* str, const size_t maxLen)
+{
+    if (!table || !str || maxLen > PRODVER_INTERN_STR_LEN) {
+        return PRODVER_INTERN_NONE;
+    }
+
+    uint32_t* slot = prodVersionInternSlot(table, str, maxLen);
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    if (table->count >= table->capacity) {
+        return PRODVER_INTERN_NONE;
+    }
+
+    uint32_t id = table->count++;
+    memset(table->strings[id], 0, sizeof(prodVersionInternStr_t));
+    prodVersionCopyField(table->strings[id], str, maxLen);
+    *slot = id + 1;
+    return id;
+}
+
+/// @brief Returns the string for an ID.
+/// @return Null-terminated string, or NULL if the ID is unknown.
+static inline const char* prodVersionInternGet(const prodVersionIntern_t* table, const uint32_t id)
+{
+    if (!table || id >= table->count) {
+        return NULL;
+    }
+    return table->strings[id];
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+/*
+    Production Version - Latest Release View
+    Nick Daria (contact@nickdaria.com)
+
+    Maintains the newest release per product per release channel, updated
+    incrementally as releases are ingested. Products are stored densely in
+    insertion order and found through an open-addressed table of entry indexes,
+    so the table can be kept sparse without repeating the large entries.
+    Storage is caller-provided so the view can live in static memory on
+    constrained targets.
+*/
+
+#include "prodversion.h"
+
+typedef struct {
+    /// @brief Bitmask of channel indexes (see prodVersionChannelIndex) that hold a release
+    uint8_t present;
+
+    /// @brief Cached product hash to skip string compares on probe collisions
+    uint32_t hash;
+
+    char product[PRODVER_FLD_PRODUCT_LEN + 1];
+
+    /// @brief Newest release per channel, indexed by prodVersionChannelIndex
+    prodVersion_t latest[PRODVER_CHANNEL_COUNT];
+} prodVersionLatestEntry_t;
+
+typedef struct {
+    /// @brief Product entries, [0, count) in use
+    prodVersionLatestEntry_t* entries;
+
+    /// @brief Maximum number of products. May be raised after growing entries, see prodVersionLatestInit.
+    size_t entryCapacity;
+
+    /// @brief Entry index + 1 per slot, 0 if empty
+    uint32_t* slots;
+
+    /// @brief Number of slots, must be a power of two
+    size_t slotCount;
+
+    /// @brief Number of distinct products stored
+    size_t count;
+} prodVersionLatest_t;
+
+/// @brief FNV-1a hash of a product identifier, bounded by the field length.
+static inline uint32_t prodVersionProductHash(const char* product)
+{
+    return prodVersionHashString(product, PRODVER_FLD_PRODUCT_LEN);
+}
+
+/// @brief Initializes an empty view over caller-provided storage.
+/// @note Entries are addressed by index, so they may be moved to a larger array (e.g. realloc) at any
+/// time by updating entries and entryCapacity. The slot table cannot grow; size it for the most products expected.
+/// @param view View to initialize.
+/// @param entries Entry storage.
+/// @param entryCapacity Number of entries.
+/// @param slots Slot storage.
+/// @param slotCount Number of slots (power of two). Keep well above the product count.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionLatestInit(prodVersionLatest_t* view, prodVersionLatestEntry_t* entries, const size_t entryCapacity,
+                                         uint32_t* slots, const size_t slotCount)
+{
+    if (!view || !entries || !slots || slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || entryCapacity >= UINT32_MAX) {
+        return false;
+    }
+
+    memset(slots, 0, slotCount * sizeof(uint32_t));
+    view->entries = entries;
+    view->entryCapacity = entryCapacity;
+    view->slots = slots;
+    view->slotCount = slotCount;
+    view->count = 0;
+    return true;
+}
+
+/// @brief Finds the slot for a product, or the empty slot it would occupy.
+/// @return Slot pointer (0 if the product is absent), or NULL if the product is absent and the table is full.
+static inline uint32_t* prodVersionLatestSlot(const prodVersionLatest_t* view, const char* product, const uint32_t hash)
+{
+    size_t mask = view->slotCount - 1;
+
+    for (size_t i = 0; i < view->slotCount; i++) {
+        uint32_t* slot = &view->slots[(hash + i) & mask];
+        if (*slot == 0) {
+            return slot;
+        }
+
+        const prodVersionLatestEntry_t* entry = &view->entries[*slot - 1];
+        if (entry->hash == hash && strncmp(entry->product, product, PRODVER_FLD_PRODUCT_LEN) == 0) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+/// @brief Ingests a release, replacing the stored one if it is newer for its product and channel.
+/// @note Ties on semantic version and build are broken by the newer date.
+/// @param view View to update.
+/// @param release Release to ingest.
+/// @param ret_updated Optional, set true if the release became the latest for its channel.
+/// @return True on success, false on unknown channel, full entries or full table.
+static inline bool prodVersionLatestIngest(prodVersionLatest_t* view, const prodVersion_t* release, bool* ret_updated)
+{
+    if (ret_updated) {
+        *ret_updated = false;
+    }
+
+    if (!view || !release) {
+        return false;
+    }
+
+    int ch = prodVersionChannelIndex(release->releaseChannel);
+    if (ch < 0) {
+        return false;
+    }
+
+    uint32_t hash = prodVersionProductHash(release->product);
+    uint32_t* slot = prodVersionLatestSlot(view, release->product, hash);
+    if (!slot) {
+        return false;
+    }
+
+    if (*slot == 0) {
+        if (view->count >= view->entryCapacity) {
+            return false;
+        }
+
+        prodVersionLatestEntry_t* added = &view->entries[view->count];
+        added->hash = hash;
+        added->present = 0;
+        memcpy(added->product, release->product, PRODVER_FLD_PRODUCT_LEN);
+        added->product[PRODVER_FLD_PRODUCT_LEN] = '\0';
+        *slot = (uint32_t)++view->count;
+    }
+
+    prodVersionLatestEntry_t* entry = &view->entries[*slot - 1];
+
+    if (entry->present & (1u << ch)) {
+        const prodVersion_t* current = &entry->latest[ch];
+        int cmp = prodVersionCompare(release, current);
+        if (cmp < 0 || (cmp == 0 && release->date <= current->date)) {
+            return true;
+        }
+    }
+
+    entry->latest[ch] = *release;
+    entry->present |= (uint8_t)(1u << ch);
+
+    if (ret_updated) {
+        *ret_updated = true;
+    }
+    return true;
+}
+
+/// @brief Looks up the newest release of a product on a channel.
+/// @param view View to query.
+/// @param product Product identifier.
+/// @param channel Release channel.
+/// @return Pointer to the stored release (valid until the next ingest), or NULL if none.
+static inline const prodVersion_t* prodVersionLatestGet(const prodVersionLatest_t* view, const char* product, const prodVersionChannel_t channel)
+{
+    if (!view || !product) {
+        return NULL;
+    }
+
+    int ch = prodVersionChannelIndex(channel);
+    if (ch < 0) {
+        return NULL;
+    }
+
+    const uint32_t* slot = prodVersionLatestSlot(view, product, prodVersionProductHash(product));
+    if (!slot || *slot == 0) {
+        return NULL;
+    }
+
+    const prodVersionLatestEntry_t* entry = &view->entries[*slot - 1];
+    if (!(entry->present & (1u << ch))) {
+        return NULL;
+    }
+
+    return &entry->latest[ch];
+}
+
+/// @brief Finds the update a device should install: the newest release of its product,
+/// on a channel it is eligible for, that is newer than what it runs.
+/// @param view View to query.
+/// @param device Version the device is currently running.
+/// @return Pointer to the stored release (valid until the next ingest), or NULL if no update applies.
+static inline const prodVersion_t* prodVersionLatestResolve(const prodVersionLatest_t* view, const prodVersion_t* device)
+{
+    if (!view || !device) {
+        return NULL;
+    }
+
+    const uint32_t* slot = prodVersionLatestSlot(view, device->product, prodVersionProductHash(device->product));
+    if (!slot || *slot == 0) {
+        return NULL;
+    }
+
+    const prodVersionLatestEntry_t* entry = &view->entries[*slot - 1];
+
+    const prodVersion_t* best = NULL;
+    uint8_t accepts = prodVersionChannelAccepts(device->releaseChannel);
+
+    for (int ch = 0; ch < PRODVER_CHANNEL_COUNT; ch++) {
+        if (!(entry->present & accepts & (1u << ch))) {
+            continue;
+        }
+
+        const prodVersion_t* candidate = &entry->latest[ch];
+        if (prodVersionCompare(candidate, device) <= 0) {
+            continue;
+        }
+
+        if (!best) {
+            best = candidate;
+            continue;
+        }
+
+        int cmp = prodVersionCompare(candidate, best);
+        if (cmp > 0 || (cmp == 0 && candidate->date > best->date)) {
+            best = candidate;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+/*
+    Production Version - Range Expressions
+    Nick Daria (contact@nickdaria.com)
+
+    Compiles range expressions such as ">=1.2.0 <2.0.0 channel:b,c product:ND*"
+    into a flat matcher over packed semantic version keys, so matching does no
+    string parsing.
+
+    Syntax (whitespace separated terms, all must match):
+        [op]M[.m[.p[.b]]]   op is one of >=, >, <=, <, = (default =). Omitted
+                            components match any value, so ">1.2" excludes every
+                            1.2.x and "<=1.2" includes every 1.2.x.
+        channel:c[,c...]    Release channel characters, any of the listed.
+        product:NAME        Exact product, or a prefix when NAME ends with '*'.
+                            Quote NAME to include spaces: product:"ND Smart*"
+*/
+
+#include "prodversion.h"
+
+typedef struct {
+    /// @brief Inclusive bounds on prodVersionPackSemver keys
+    uint64_t minKey;
+    uint64_t maxKey;
+
+    /// @brief Accepted channels as prodVersionChannelMask bits
+    uint8_t channels;
+
+    /// @brief True to compare only the first productLen characters
+    bool productPrefix;
+    uint8_t productLen;
+    char product[PRODVER_FLD_PRODUCT_LEN + 1];
+} prodVersionRange_t;
+
+/// @brief Parses "M[.m[.p[.b]]]" into the lowest and highest keys it covers.
+/// @return Characters consumed, or 0 if not a version.
+static inline size_t prodVersionRangeParseVersion(const char* str, const size_t len, uint64_t* ret_lo, uint64_t* ret_hi)
+{
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    size_t pos = 0;
+    int parts = 0;
+
+    while (parts < 4) {
+        if (pos >= len || str[pos] < '0' || str[pos] > '9') {
+            return 0;
+        }
+
+        uint32_t value = 0;
+        while (pos < len && str[pos] >= '0' && str[pos] <= '9') {
+            value = value * 10 + (uint32_t)(str[pos++] - '0');
+            if (value > UINT16_MAX) {
+                return 0;
+            }
+        }
+
+        lo = (lo << 16) | value;
+        hi = (hi << 16) | value;
+        parts++;
+
+        if (pos < len && str[pos] == '.') {
+            pos++;
+        } else {
+            break;
+        }
+    }
+
+    if (pos != len) {
+        return 0;
+    }
+
+    //  Omitted components span their whole range
+    for (; parts < 4; parts++) {
+        lo = lo << 16;
+        hi = (hi << 16) | UINT16_MAX;
+    }
+
+    *ret_lo = lo;
+    *ret_hi = hi;
+    return pos;
+}
+
+/// @brief Compiles a single term into the range.
+static inline bool prodVersionRangeCompileTerm(prodVersionRange_t* range, const char* term, const size_t len)
+{
+    if (len > 8 && strncmp(term, "channel:", 8) == 0) {
+        uint8_t mask = 0;
+        for (size_t i = 8; i < len; i++) {
+            if (term[i] == ',') {
+                continue;
+            }
+
+            uint8_t bit = prodVersionChannelMask((prodVersionChannel_t)(uint8_t)term[i]);
+            if (!bit || (i + 1 < len && term[i + 1] != ',')) {
+                return false;
+            }
+            mask |= bit;
+        }
+
+        range->channels &= mask;
+        return true;
+    }
+
+    if (len > 8 && strncmp(term, "product:", 8) == 0) {
+        const char* name = term + 8;
+        size_t plen = len - 8;
+        if (name[0] == '"') {
+            if (plen < 2 || name[plen - 1] != '"') {
+                return false;
+            }
+            name++;
+            plen -= 2;
+        }
+
+        bool prefix = plen > 0 && name[plen - 1] == '*';
+        if (prefix) {
+            plen--;
+        }
+        if (plen > PRODVER_FLD_PRODUCT_LEN || memchr(name, '"', plen) || range->productLen || range->productPrefix) {
+            return false;
+        }
+
+        memset(range->product, 0, sizeof(range->product));
+        memcpy(range->product, name, plen);
+        range->productLen = (uint8_t)plen;
+        range->productPrefix = prefix;
+        return true;
+    }
+
+    //  Comparator
+    size_t opLen = 0;
+    char op = '=';
+    bool inclusive = true;
+    if (len >= 2 && (term[0] == '>' || term[0] == '<') && term[1] == '=') {
+        op = term[0];
+        opLen = 2;
+    } else if (len >= 1 && (term[0] == '>' || term[0] == '<')) {
+        op = term[0];
+        inclusive = false;
+        opLen = 1;
+    } else if (len >= 1 && term[0] == '=') {
+        opLen = 1;
+    }
+
+    uint64_t lo;
+    uint64_t hi;
+    if (!prodVersionRangeParseVersion(term + opLen, len - opLen, &lo, &hi)) {
+        return false;
+    }
+
+    if (op == '>' || op == '=') {
+        uint64_t min = lo;
+        if (op == '>' && !inclusive) {
+            if (hi == UINT64_MAX) {
+                //  Nothing is greater, leave an empty range
+                range->minKey = UINT64_MAX;
+                range->maxKey = 0;
+                return true;
+            }
+            min = hi + 1;
+        }
+        if (min > range->minKey) range->minKey = min;
+    }
+
+    if (op == '<' || op == '=') {
+        uint64_t max = hi;
+        if (op == '<' && !inclusive) {
+            if (lo == 0) {
+                range->minKey = UINT64_MAX;
+                range->maxKey = 0;
+                return true;
+            }
+            max = lo - 1;
+        }
+        if (max < range->maxKey) range->maxKey = max;
+    }
+
+    return true;
+}
+
+/// @brief Compiles a range expression.
+/// @param expr Null-terminated expression, an empty expression matches everything.
+/// @param ret_range Destination matcher.
+/// @param ret_errorOffset Optional, set to the offset of the first bad term on failure.
+/// @return True on success, false on a syntax error.
+static inline bool prodVersionRangeCompile(const char* expr, prodVersionRange_t* ret_range, size_t* ret_errorOffset)
+{
+    if (!expr || !ret_range) {
+        return false;
+    }
+
+    memset(ret_range, 0, sizeof(prodVersionRange_t));
+    ret_range->minKey = 0;
+    ret_range->maxKey = UINT64_MAX;
+    ret_range->channels = 0x7F;
+
+    size_t pos = 0;
+    for (;;) {
+        while (expr[pos] == ' ' || expr[pos] == '\t') {
+            pos++;
+        }
+        if (!expr[pos]) {
+            return true;
+        }
+
+        //  Whitespace inside double quotes does not end a term
+        size_t start = pos;
+        bool quoted = false;
+        while (expr[pos] && (quoted || (expr[pos] != ' ' && expr[pos] != '\t'))) {
+            quoted ^= (expr[pos] == '"');
+            pos++;
+        }
+
+        if (!prodVersionRangeCompileTerm(ret_range, expr + start, pos - start)) {
+            if (ret_errorOffset) {
+                *ret_errorOffset = start;
+            }
+            return false;
+        }
+    }
+}
+
+/// @brief Checks a product against the range's product filter.
+static inline bool prodVersionRangeMatchProduct(const prodVersionRange_t* range, const char* product)
+{
+    if (range->productPrefix) {
+        return memcmp(product, range->product, range->productLen) == 0;
+    }
+    if (range->productLen == 0) {
+        return true;
+    }
+    return strncmp(product, range->product, PRODVER_FLD_PRODUCT_LEN) == 0;
+}
+
+/// @brief Checks a decoded version against a compiled range.
+static inline bool prodVersionRangeMatch(const prodVersionRange_t* range, const prodVersion_t* version)
+{
+    uint64_t key = prodVersionPackSemver(version);
+    return key >= range->minKey && key <= range->maxKey &&
+           (range->channels & prodVersionChannelMask(version->releaseChannel)) &&
+           prodVersionRangeMatchProduct(range, version->product);
+}
+
+/// @brief Checks an encoded version against a compiled range without decoding it.
+/// @param buf Encoded version (must be at least 64 bytes, not validated).
+static inline bool prodVersionRangeMatchBytes(const prodVersionRange_t* range, const char* buf)
+{
+    uint64_t key = prodVersionPeekSemver(buf);
+    return key >= range->minKey && key <= range->maxKey &&
+           (range->channels & prodVersionChannelMask((prodVersionChannel_t)(uint8_t)buf[PRODVER_OFS_CHANNEL])) &&
+           prodVersionRangeMatchProduct(range, buf + PRODVER_OFS_PRODUCT);
+}
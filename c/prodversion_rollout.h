@@ -0,0 +1,157 @@
+#pragma once
+
+/*
+    Production Version - Staged Rollout
+    Nick Daria (contact@nickdaria.com)
+
+    Splits the fleet into waves for one release. Each device lands in a fixed
+    bucket from a hash of its ID seeded by the release, so assignment is
+    deterministic, needs no per-device state and reshuffles between releases.
+    Waves cover cumulative shares of the buckets and each admits a set of
+    device channels. A device is offered the release once any live wave covers
+    its bucket and admits its channel, so a later, wider wave picks up devices
+    an earlier wave held back by channel. Deciding if a device is in an active
+    wave is a hash and at most PRODVER_ROLLOUT_MAX_WAVES compares, plus the
+    optional compatibility check against the device's hardware.
+*/
+
+#include "prodversion_compat.h"
+
+#define PRODVER_ROLLOUT_MAX_WAVES     8
+
+/// @brief Bucket resolution, shares are given in basis points
+#define PRODVER_ROLLOUT_BUCKETS       10000
+
+typedef struct {
+    /// @brief Buckets covered by this and every earlier wave, out of PRODVER_ROLLOUT_BUCKETS
+    uint16_t cumulative;
+
+    /// @brief Device channels admitted, prodVersionChannelMask bits
+    uint8_t channels;
+} prodVersionRolloutWave_t;
+
+typedef struct {
+    prodVersion_t release;
+
+    /// @brief Optional compatibility rules the release must satisfy on the device's hardware
+    const prodVersionCompat_t* compat;
+
+    uint64_t seed;
+    uint8_t releaseMask;
+
+    prodVersionRolloutWave_t waves[PRODVER_ROLLOUT_MAX_WAVES];
+    uint8_t waveCount;
+
+    /// @brief Waves [0, activeWaves) are live
+    uint8_t activeWaves;
+} prodVersionRollout_t;
+
+/// @brief Initializes a rollout with no waves.
+/// @param rollout Rollout to initialize.
+/// @param release Target release, copied.
+/// @param compat Optional built compatibility rules, must outlive rollout. NULL to skip the check.
+/// @return True on success, false on bad arguments.
+static inline bool prodVersionRolloutInit(prodVersionRollout_t* rollout, const prodVersion_t* release, const prodVersionCompat_t* compat)
+{
+    if (!rollout || !release) {
+        return false;
+    }
+
+    memset(rollout, 0, sizeof(prodVersionRollout_t));
+    rollout->release = *release;
+    rollout->compat = compat;
+    rollout->releaseMask = prodVersionChannelMask(release->releaseChannel);
+    rollout->seed = ((uint64_t)prodVersionHashString(release->product, PRODVER_FLD_PRODUCT_LEN) << 32) ^ prodVersionPackSemver(release);
+    return true;
+}
+
+/// @brief Appends a wave.
+/// @param rollout Rollout.
+/// @param cumulative Share of the fleet covered once this wave is live, in basis points (e.g. 100 = 1%), not below the previous wave.
+/// @param channels Device channels admitted, e.g. PRODVER_CHANNEL_BIT(VERSION_CHANNEL_BETA) | PRODVER_CHANNEL_BIT(VERSION_CHANNEL_RELEASE).
+/// @return True on success, false if full or the share is out of order.
+static inline bool prodVersionRolloutAddWave(prodVersionRollout_t* rollout, const uint16_t cumulative, const uint8_t channels)
+{
+    if (!rollout || rollout->waveCount >= PRODVER_ROLLOUT_MAX_WAVES || cumulative > PRODVER_ROLLOUT_BUCKETS) {
+        return false;
+    }
+    if (rollout->waveCount && cumulative < rollout->waves[rollout->waveCount - 1].cumulative) {
+        return false;
+    }
+
+    rollout->waves[rollout->waveCount].cumulative = cumulative;
+    rollout->waves[rollout->waveCount].channels = channels;
+    rollout->waveCount++;
+    return true;
+}
+
+/// @brief Sets how many waves are live, e.g. advanced as monitoring clears each one.
+/// @return True on success, false if more than the added waves.
+static inline bool prodVersionRolloutSetActive(prodVersionRollout_t* rollout, const uint8_t activeWaves)
+{
+    if (!rollout || activeWaves > rollout->waveCount) {
+        return false;
+    }
+
+    rollout->activeWaves = activeWaves;
+    return true;
+}
+
+/// @brief Deterministic bucket of a device for this rollout.
+/// @return Bucket in [0, PRODVER_ROLLOUT_BUCKETS).
+static inline uint16_t prodVersionRolloutBucket(const prodVersionRollout_t* rollout, const uint64_t deviceId)
+{
+    //  splitmix64 finalizer, then multiply-shift into range
+    uint64_t x = deviceId ^ rollout->seed;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return (uint16_t)(((x >> 32) * PRODVER_ROLLOUT_BUCKETS) >> 32);
+}
+
+/// @brief First wave covering a device's bucket, regardless of gates or whether the wave is live.
+/// @note Every later wave covers the bucket too, see prodVersionRolloutIncludes.
+/// @return Wave index, or -1 if beyond the last wave.
+static inline int prodVersionRolloutWaveOf(const prodVersionRollout_t* rollout, const uint64_t deviceId)
+{
+    if (!rollout) {
+        return -1;
+    }
+
+    uint16_t bucket = prodVersionRolloutBucket(rollout, deviceId);
+    for (int w = 0; w < rollout->waveCount; w++) {
+        if (bucket < rollout->waves[w].cumulative) {
+            return w;
+        }
+    }
+    return -1;
+}
+
+/// @brief Checks if a device should be offered the release now.
+/// @param rollout Rollout.
+/// @param deviceId Device.
+/// @param deviceChannel Channel the device is subscribed to.
+/// @param hardware Device's hardware version, may be NULL if the rollout has no compatibility rules.
+/// @return True if a live wave covering the device admits its channel, the channel may install the release and the release is compatible with the hardware.
+static inline bool prodVersionRolloutIncludes(const prodVersionRollout_t* rollout, const uint64_t deviceId, const prodVersionChannel_t deviceChannel, const prodVersion_t* hardware)
+{
+    if (!rollout || !(prodVersionChannelAccepts(deviceChannel) & rollout->releaseMask)) {
+        return false;
+    }
+
+    //  Waves are cumulative, so every live wave from the first covering one onward includes the bucket
+    int wave = prodVersionRolloutWaveOf(rollout, deviceId);
+    if (wave < 0) {
+        return false;
+    }
+
+    uint8_t channels = 0;
+    for (int w = wave; w < rollout->activeWaves; w++) {
+        channels |= rollout->waves[w].channels;
+    }
+    if (!(channels & prodVersionChannelMask(deviceChannel))) {
+        return false;
+    }
+
+    return !rollout->compat || prodVersionCompatAllowed(rollout->compat, &rollout->release, hardware);
+}
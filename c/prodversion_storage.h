@@ -0,0 +1,211 @@
+#pragma once
+
+/*
+    Production Version - Persistent Storage
+    Nick Daria (contact@nickdaria.com)
+
+    Stores an encoded version on EEPROM/flash using two alternating slots (A/B).
+    Each write goes to the slot not holding the current record with the next
+    sequence number, so a power loss mid-write leaves the previous record
+    intact and writes are spread across both slots. Torn writes are detected by
+    CRC. Mounting reads both slot headers and then only the newest slot in full,
+    falling back to the other slot if that one fails its CRC. The validated
+    record is cached, so reads after mounting do not touch the device.
+
+    Slot layout (PRODVER_SLOT_LEN bytes, big-endian):
+        [0 - 3]     PRODVER_SLOT_MAGIC
+        [4 - 7]     Sequence number
+        [8 - 71]    Encoded version
+        [72 - 75]   CRC-32 of bytes 0 - 71
+*/
+
+#include "prodversion.h"
+
+#define PRODVER_SLOT_MAGIC            0x50565331u     //  "PVS1"
+#define PRODVER_SLOT_HEADER_LEN       8
+#define PRODVER_SLOT_LEN              (PRODVER_SLOT_HEADER_LEN + PRODVER_ENCODED_LEN + 4)
+
+/// @brief Block device backing the slots. Offsets are relative to the device.
+typedef struct {
+    /// @return True on success
+    bool (*read)(void* ctx, uint32_t offset, void* buf, size_t len);
+
+    /// @return True on success
+    bool (*write)(void* ctx, uint32_t offset, const void* buf, size_t len);
+
+    /// @brief Optional, erases a slot before writing (flash). NULL for EEPROM.
+    /// @return True on success
+    bool (*erase)(void* ctx, uint32_t offset, size_t len);
+
+    void* ctx;
+} prodVersionBlockDev_t;
+
+typedef struct {
+    const prodVersionBlockDev_t* dev;
+
+    /// @brief Offset of slot A, slot B follows at base + slotStride
+    uint32_t base;
+
+    /// @brief Distance between slots, at least PRODVER_SLOT_LEN (e.g. a flash sector)
+    uint32_t slotStride;
+
+    /// @brief Slot holding the current record (0 or 1), -1 if none
+    int active;
+    uint32_t sequence;
+
+    /// @brief Encoded current record, valid when active >= 0
+    char record[PRODVER_ENCODED_LEN];
+} prodVersionStorage_t;
+
+/// @brief CRC-32 (IEEE 802.3), bitwise to avoid a table on small targets.
+static inline uint32_t prodVersionCrc32(const uint8_t* data, const size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static inline uint32_t prodVersionStorageReadU32(const uint8_t* buf)
+{
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+}
+
+static inline void prodVersionStorageWriteU32(uint8_t* buf, const uint32_t value)
+{
+    buf[0] = (uint8_t)(value >> 24);
+    buf[1] = (uint8_t)(value >> 16);
+    buf[2] = (uint8_t)(value >> 8);
+    buf[3] = (uint8_t)value;
+}
+
+/// @brief Reads a slot and checks it is complete.
+/// @return True if the slot holds a valid record.
+static inline bool prodVersionStorageReadSlot(const prodVersionStorage_t* storage, const int slot, uint8_t* ret_raw)
+{
+    uint32_t offset = storage->base + (uint32_t)slot * storage->slotStride;
+    if (!storage->dev->read(storage->dev->ctx, offset, ret_raw, PRODVER_SLOT_LEN)) {
+        return false;
+    }
+
+    if (prodVersionStorageReadU32(ret_raw) != PRODVER_SLOT_MAGIC) {
+        return false;
+    }
+
+    uint32_t crc = prodVersionStorageReadU32(ret_raw + PRODVER_SLOT_LEN - 4);
+    return crc == prodVersionCrc32(ret_raw, PRODVER_SLOT_LEN - 4);
+}
+
+/// @brief Makes a validated slot the current record.
+static inline void prodVersionStorageActivate(prodVersionStorage_t* storage, const int slot, const uint8_t* raw)
+{
+    storage->active = slot;
+    storage->sequence = prodVersionStorageReadU32(raw + 4);
+    memcpy(storage->record, raw + PRODVER_SLOT_HEADER_LEN, PRODVER_ENCODED_LEN);
+}
+
+/// @brief Mounts storage, finding and caching the newest valid slot.
+/// @param storage Storage to mount.
+/// @param dev Block device, must outlive storage.
+/// @param base Offset of slot A.
+/// @param slotStride Distance between slots, at least PRODVER_SLOT_LEN.
+/// @return True on success (including when no record is stored yet), false on bad arguments.
+static inline bool prodVersionStorageMount(prodVersionStorage_t* storage, const prodVersionBlockDev_t* dev, const uint32_t base, const uint32_t slotStride)
+{
+    if (!storage || !dev || !dev->read || !dev->write || slotStride < PRODVER_SLOT_LEN) {
+        return false;
+    }
+
+    storage->dev = dev;
+    storage->base = base;
+    storage->slotStride = slotStride;
+    storage->active = -1;
+    storage->sequence = 0;
+
+    //  Headers only, blank (erased or zeroed) slots are skipped without reading their payload
+    uint8_t header[2][PRODVER_SLOT_HEADER_LEN];
+    bool present[2];
+    for (int slot = 0; slot < 2; slot++) {
+        uint32_t offset = base + (uint32_t)slot * slotStride;
+        present[slot] = dev->read(dev->ctx, offset, header[slot], PRODVER_SLOT_HEADER_LEN) &&
+                        prodVersionStorageReadU32(header[slot]) == PRODVER_SLOT_MAGIC;
+    }
+
+    //  Newest first, serial number arithmetic so the sequence may wrap
+    int first = 0;
+    if (present[0] && present[1]) {
+        int32_t diff = (int32_t)(prodVersionStorageReadU32(header[1] + 4) - prodVersionStorageReadU32(header[0] + 4));
+        first = (diff > 0) ? 1 : 0;
+    } else if (present[1]) {
+        first = 1;
+    }
+
+    //  Usually one full read; the older slot is only read if the newer one was torn
+    uint8_t raw[PRODVER_SLOT_LEN];
+    for (int i = 0; i < 2; i++) {
+        int slot = (i == 0) ? first : 1 - first;
+        if (present[slot] && prodVersionStorageReadSlot(storage, slot, raw)) {
+            prodVersionStorageActivate(storage, slot, raw);
+            break;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Reads the current record from the copy cached at mount or last write.
+/// @param storage Mounted storage.
+/// @param ret_version Destination.
+/// @return True on success, false if nothing is stored or the record fails to decode.
+static inline bool prodVersionStorageRead(const prodVersionStorage_t* storage, prodVersion_t* ret_version)
+{
+    if (!storage || !ret_version || storage->active < 0) {
+        return false;
+    }
+
+    return prodVersionDecodeBytes(storage->record, PRODVER_ENCODED_LEN, ret_version);
+}
+
+/// @brief Atomically replaces the stored record by writing the inactive slot.
+/// @note If power is lost during the write, the next mount returns the previous record.
+/// @param storage Mounted storage.
+/// @param version Version to store.
+/// @return True on success, false on encode or device error.
+static inline bool prodVersionStorageWrite(prodVersionStorage_t* storage, const prodVersion_t* version)
+{
+    if (!storage || !version) {
+        return false;
+    }
+
+    uint8_t raw[PRODVER_SLOT_LEN];
+    uint32_t seq = storage->sequence + 1;
+    prodVersionStorageWriteU32(raw, PRODVER_SLOT_MAGIC);
+    prodVersionStorageWriteU32(raw + 4, seq);
+    if (!prodVersionEncodeBytes((char*)raw + PRODVER_SLOT_HEADER_LEN, PRODVER_ENCODED_LEN, version)) {
+        return false;
+    }
+    prodVersionStorageWriteU32(raw + PRODVER_SLOT_LEN - 4, prodVersionCrc32(raw, PRODVER_SLOT_LEN - 4));
+
+    int target = (storage->active == 0) ? 1 : 0;
+    uint32_t offset = storage->base + (uint32_t)target * storage->slotStride;
+
+    if (storage->dev->erase && !storage->dev->erase(storage->dev->ctx, offset, storage->slotStride)) {
+        return false;
+    }
+    if (!storage->dev->write(storage->dev->ctx, offset, raw, PRODVER_SLOT_LEN)) {
+        return false;
+    }
+
+    //  Only switch once the write reads back intact
+    uint8_t check[PRODVER_SLOT_LEN];
+    if (!prodVersionStorageReadSlot(storage, target, check) || memcmp(check, raw, PRODVER_SLOT_LEN) != 0) {
+        return false;
+    }
+
+    prodVersionStorageActivate(storage, target, raw);
+    return true;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+/*
+    Production Version - File-Backed Storage Simulator
+    Nick Daria (contact@nickdaria.com)
+
+    Block device for prodversion_storage.h backed by a host file, for testing
+    storage logic off-target. Unwritten space reads as erased flash (0xFF), both
+    past the end of the file and in gaps skipped by a write. Can emulate flash
+    erase and power loss by cutting the next write short.
+*/
+
+#include "prodversion_storage.h"
+
+typedef struct {
+    FILE* file;
+
+    /// @brief If non-zero, the next write stops after this many bytes and fails, emulating power loss
+    size_t tearNextWriteAt;
+} prodVersionFileDev_t;
+
+static inline bool prodVersionFileDevRead(void* ctx, uint32_t offset, void* buf, size_t len)
+{
+    prodVersionFileDev_t* dev = (prodVersionFileDev_t*)ctx;
+    if (fseek(dev->file, (long)offset, SEEK_SET) != 0) {
+        return false;
+    }
+
+    //  Unwritten space reads as erased
+    size_t got = fread(buf, 1, len, dev->file);
+    memset((char*)buf + got, 0xFF, len - got);
+    return true;
+}
+
+/// @brief Extends the file with erased bytes up to offset, so skipped space never reads back as a zero-filled hole.
+static inline bool prodVersionFileDevExtend(prodVersionFileDev_t* dev, uint32_t offset)
+{
+    if (fseek(dev->file, 0, SEEK_END) != 0) {
+        return false;
+    }
+
+    long end = ftell(dev->file);
+    if (end < 0) {
+        return false;
+    }
+
+    while ((uint32_t)end < offset) {
+        if (fputc(0xFF, dev->file) == EOF) {
+            return false;
+        }
+        end++;
+    }
+    return true;
+}
+
+static inline bool prodVersionFileDevWrite(void* ctx, uint32_t offset, const void* buf, size_t len)
+{
+    prodVersionFileDev_t* dev = (prodVersionFileDev_t*)ctx;
+    if (!prodVersionFileDevExtend(dev, offset) || fseek(dev->file, (long)offset, SEEK_SET) != 0) {
+        return false;
+    }
+
+    size_t want = len;
+    if (dev->tearNextWriteAt && dev->tearNextWriteAt < len) {
+        want = dev->tearNextWriteAt;
+    }
+    bool torn = want != len;
+    dev->tearNextWriteAt = 0;
+
+    bool ok = fwrite(buf, 1, want, dev->file) == want && fflush(dev->file) == 0;
+    return ok && !torn;
+}
+
+static inline bool prodVersionFileDevErase(void* ctx, uint32_t offset, size_t len)
+{
+    uint8_t erased[64];
+    memset(erased, 0xFF, sizeof(erased));
+
+    prodVersionFileDev_t* dev = (prodVersionFileDev_t*)ctx;
+    if (!prodVersionFileDevExtend(dev, offset) || fseek(dev->file, (long)offset, SEEK_SET) != 0) {
+        return false;
+    }
+
+    while (len > 0) {
+        size_t n = (len < sizeof(erased)) ? len : sizeof(erased);
+        if (fwrite(erased, 1, n, dev->file) != n) {
+            return false;
+        }
+        len -= n;
+    }
+    return fflush(dev->file) == 0;
+}
+
+/// @brief Opens (creating if needed) a file as a block device.
+/// @param fileDev Simulator state, must outlive ret_dev.
+/// @param ret_dev Block device to pass to prodVersionStorageMount.
+/// @param path Backing file.
+/// @param flash True to emulate flash erase before each slot write.
+/// @return True on success.
+static inline bool prodVersionFileDevOpen(prodVersionFileDev_t* fileDev, prodVersionBlockDev_t* ret_dev, const char* path, const bool flash)
+{
+    if (!fileDev || !ret_dev || !path) {
+        return false;
+    }
+
+    fileDev->file = fopen(path, "r+b");
+    if (!fileDev->file) {
+        fileDev->file = fopen(path, "w+b");
+    }
+    if (!fileDev->file) {
+        return false;
+    }
+    fileDev->tearNextWriteAt = 0;
+
+    ret_dev->read = prodVersionFileDevRead;
+    ret_dev->write = prodVersionFileDevWrite;
+    ret_dev->erase = flash ? prodVersionFileDevErase : NULL;
+    ret_dev->ctx = fileDev;
+    return true;
+}
+
+/// @brief Closes the backing file.
+static inline void prodVersionFileDevClose(prodVersionFileDev_t* fileDev)
+{
+    if (fileDev && fileDev->file) {
+        fclose(fileDev->file);
+        fileDev->file = NULL;
+    }
+}
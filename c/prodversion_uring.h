@@ -0,0 +1,316 @@
+#pragma once
+
+/*
+    Production Version - io_uring Bulk Loader
+    Nick Daria (contact@nickdaria.com)
+
+    Streams large files of back-to-back 64-byte encoded records through
+    io_uring, keeping several O_DIRECT reads into registered buffers in flight
+    while completed chunks are decoded. Linux only, link with -luring (2.2 or
+    newer).
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <liburing.h>
+
+#include "prodversion.h"
+
+/// Bytes per read, a multiple of both the record size and typical O_DIRECT alignment
+#define PRODVER_URING_CHUNK_LEN       (1024 * 1024)
+
+/// Reads kept in flight
+#define PRODVER_URING_QUEUE_DEPTH     8
+
+/// Buffer alignment required by O_DIRECT
+#define PRODVER_URING_ALIGN           4096
+
+/// user_data of cancel requests, distinct from slot indexes
+#define PRODVER_URING_CANCEL_TAG      UINT64_MAX
+
+/// @brief Receives each decoded record.
+/// @note Chunks complete out of order, so records are not delivered in file order; use index to place them.
+/// @param version Decoded record, only valid for the duration of the call.
+/// @param index Position of the record in the file.
+/// @param ctx Caller context.
+/// @return False to stop loading.
+typedef bool (*prodVersionLoadCallback_t)(const prodVersion_t* version, uint64_t index, void* ctx);
+
+typedef struct {
+    char* buf;
+    uint64_t offset;
+    size_t want;
+    size_t filled;
+
+    /// @brief True while a read into buf is outstanding
+    bool busy;
+
+    /// @brief Rest of the chunk is read through the buffered descriptor, see prodVersionLoadFile
+    bool buffered;
+} prodVersionUringSlot_t;
+
+/// @brief Queues a fixed-buffer read for the unread part of a slot.
+static inline bool prodVersionUringQueue(struct io_uring* ring, int fd, prodVersionUringSlot_t* slot, unsigned index)
+{
+    struct io_uring_sqe* sqe = io_uring_get_sqe(ring);
+    if (!sqe) {
+        return false;
+    }
+
+    io_uring_prep_read_fixed(sqe, fd, slot->buf + slot->filled, (unsigned)(slot->want - slot->filled), slot->offset + slot->filled, (int)index);
+    io_uring_sqe_set_data64(sqe, index);
+    slot->busy = true;
+    return true;
+}
+
+/// @brief Queues cancellation of every outstanding read, so teardown does not wait on them.
+/// @return Number of cancel requests queued, each producing one extra completion.
+static inline unsigned prodVersionUringCancelAll(struct io_uring* ring, const prodVersionUringSlot_t* slots)
+{
+    unsigned queued = 0;
+    for (unsigned i = 0; i < PRODVER_URING_QUEUE_DEPTH; i++) {
+        if (!slots[i].busy) {
+            continue;
+        }
+
+        struct io_uring_sqe* sqe = io_uring_get_sqe(ring);
+        if (!sqe) {
+            break;
+        }
+        io_uring_prep_cancel64(sqe, i, 0);
+        io_uring_sqe_set_data64(sqe, PRODVER_URING_CANCEL_TAG);
+        queued++;
+    }
+    return queued;
+}
+
+/// @brief Loads every record of a file of encoded versions.
+/// @note Uses O_DIRECT when the filesystem supports it, re-reading from the last aligned block after a short read
+/// and finishing the chunk through a buffered descriptor if that makes no progress. A trailing partial record is ignored.
+/// @param path File to load.
+/// @param callback Called for each successfully decoded record.
+/// @param ctx Passed to callback.
+/// @param ret_rejected Optional, set to the number of records that failed to decode.
+/// @return Number of records decoded, or a negative errno on failure.
+static inline int64_t prodVersionLoadFile(const char* path, prodVersionLoadCallback_t callback, void* ctx, uint64_t* ret_rejected)
+{
+    if (ret_rejected) {
+        *ret_rejected = 0;
+    }
+
+    if (!path || !callback) {
+        return -EINVAL;
+    }
+
+    bool direct = true;
+    int fd = open(path, O_RDONLY | O_DIRECT | O_CLOEXEC);
+    if (fd < 0 && errno == EINVAL) {
+        direct = false;
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0) {
+        return -errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        return -err;
+    }
+    uint64_t size = (uint64_t)st.st_size;
+
+    struct io_uring ring;
+    int ret = io_uring_queue_init(PRODVER_URING_QUEUE_DEPTH, &ring, 0);
+    if (ret < 0) {
+        close(fd);
+        return ret;
+    }
+
+    char* pool = NULL;
+    if (posix_memalign((void**)&pool, PRODVER_URING_ALIGN, (size_t)PRODVER_URING_CHUNK_LEN * PRODVER_URING_QUEUE_DEPTH) != 0) {
+        io_uring_queue_exit(&ring);
+        close(fd);
+        return -ENOMEM;
+    }
+
+    prodVersionUringSlot_t slots[PRODVER_URING_QUEUE_DEPTH];
+    struct iovec iov[PRODVER_URING_QUEUE_DEPTH];
+    for (unsigned i = 0; i < PRODVER_URING_QUEUE_DEPTH; i++) {
+        slots[i].buf = pool + (size_t)i * PRODVER_URING_CHUNK_LEN;
+        slots[i].busy = false;
+        slots[i].buffered = false;
+        iov[i].iov_base = slots[i].buf;
+        iov[i].iov_len = PRODVER_URING_CHUNK_LEN;
+    }
+
+    ret = io_uring_register_buffers(&ring, iov, PRODVER_URING_QUEUE_DEPTH);
+    if (ret < 0) {
+        free(pool);
+        io_uring_queue_exit(&ring);
+        close(fd);
+        return ret;
+    }
+
+    //  Prime the queue with the first chunks
+    uint64_t nextOffset = 0;
+    unsigned inFlight = 0;
+    for (unsigned i = 0; i < PRODVER_URING_QUEUE_DEPTH && nextOffset < size; i++) {
+        slots[i].offset = nextOffset;
+        slots[i].want = PRODVER_URING_CHUNK_LEN;
+        slots[i].filled = 0;
+        nextOffset += PRODVER_URING_CHUNK_LEN;
+
+        prodVersionUringQueue(&ring, fd, &slots[i], i);
+        inFlight++;
+    }
+
+    //  Opened on demand to finish a chunk whose O_DIRECT short read left nothing aligned to resume from
+    int bufferedFd = -1;
+
+    int64_t decoded = 0;
+    uint64_t rejected = 0;
+    bool stop = false;
+    bool cancelled = false;
+    bool orphaned = false;
+    unsigned cancels = 0;
+    ret = 0;
+
+    //  Every read must complete before the pool is unregistered and freed, or the kernel may write into freed memory
+    while (inFlight > 0 || cancels > 0) {
+        if (stop && !cancelled) {
+            cancels += prodVersionUringCancelAll(&ring, slots);
+            cancelled = true;
+        }
+        io_uring_submit(&ring);
+
+        struct io_uring_cqe* cqe;
+        int waitRet = io_uring_wait_cqe(&ring, &cqe);
+        if (waitRet == -EINTR) {
+            continue;
+        }
+        if (waitRet < 0) {
+            if (ret == 0) {
+                ret = waitRet;
+            }
+
+            //  Cancel and keep draining once; if waiting still fails, reads may be outstanding
+            if (!cancelled) {
+                stop = true;
+                continue;
+            }
+            orphaned = true;
+            break;
+        }
+
+        uint64_t tag = io_uring_cqe_get_data64(cqe);
+        int res = cqe->res;
+        io_uring_cqe_seen(&ring, cqe);
+
+        if (tag == PRODVER_URING_CANCEL_TAG) {
+            cancels--;
+            continue;
+        }
+
+        unsigned index = (unsigned)tag;
+        prodVersionUringSlot_t* slot = &slots[index];
+        slot->busy = false;
+        inFlight--;
+
+        if (res < 0 && !stop) {
+            ret = res;
+            stop = true;
+        }
+        if (stop) {
+            continue;
+        }
+
+        //  Short read before EOF, read the rest of the chunk
+        size_t resumeFrom = slot->filled;
+        slot->filled += (size_t)res;
+        if (res > 0 && slot->filled < slot->want && slot->offset + slot->filled < size) {
+            //  O_DIRECT offsets must stay block aligned, so re-read the partial block. If no whole
+            //  block arrived, finish the chunk buffered instead of retrying the same read.
+            if (direct && !slot->buffered) {
+                size_t aligned = slot->filled & ~(size_t)(PRODVER_URING_ALIGN - 1);
+                if (aligned > resumeFrom) {
+                    slot->filled = aligned;
+                } else {
+                    if (bufferedFd < 0) {
+                        bufferedFd = open(path, O_RDONLY | O_CLOEXEC);
+                    }
+                    if (bufferedFd < 0) {
+                        ret = -errno;
+                        stop = true;
+                        continue;
+                    }
+                    slot->buffered = true;
+                }
+            }
+
+            prodVersionUringQueue(&ring, slot->buffered ? bufferedFd : fd, slot, index);
+            inFlight++;
+            continue;
+        }
+
+        //  Decode while the other reads are in flight
+        size_t records = slot->filled / PRODVER_ENCODED_LEN;
+        uint64_t firstIndex = slot->offset / PRODVER_ENCODED_LEN;
+        for (size_t r = 0; r < records && !stop; r++) {
+            prodVersion_t version;
+            if (!prodVersionDecodeBytes(slot->buf + r * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &version)) {
+                rejected++;
+                continue;
+            }
+
+            decoded++;
+            stop = !callback(&version, firstIndex + r, ctx);
+        }
+
+        //  Reuse the slot for the next chunk
+        if (!stop && nextOffset < size) {
+            slot->offset = nextOffset;
+            slot->want = PRODVER_URING_CHUNK_LEN;
+            slot->filled = 0;
+            slot->buffered = false;
+            nextOffset += PRODVER_URING_CHUNK_LEN;
+
+            prodVersionUringQueue(&ring, fd, slot, index);
+            inFlight++;
+        }
+    }
+
+    //  Reads still outstanding, leak the pool rather than free memory the kernel may write to
+    if (orphaned) {
+        io_uring_queue_exit(&ring);
+        close(fd);
+        if (bufferedFd >= 0) {
+            close(bufferedFd);
+        }
+        if (ret_rejected) {
+            *ret_rejected = rejected;
+        }
+        return ret;
+    }
+
+    io_uring_unregister_buffers(&ring);
+    io_uring_queue_exit(&ring);
+    free(pool);
+    close(fd);
+    if (bufferedFd >= 0) {
+        close(bufferedFd);
+    }
+
+    if (ret_rejected) {
+        *ret_rejected = rejected;
+    }
+    return (ret < 0) ? ret : decoded;
+}
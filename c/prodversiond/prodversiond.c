@@ -0,0 +1,437 @@
+/*
+    Production Version - Update Query Daemon
+    Nick Daria (contact@nickdaria.com)
+
+    Loads a catalog of encoded prodVersion_t records and answers "what update
+    applies to this version" over a Unix or TCP socket (Linux, epoll).
+
+    Protocol:
+        Clients send back-to-back PRODVER_ENCODED_LEN byte frames, each the
+        encoded version a device is currently running. Every frame is answered,
+        in order, with one PRODVER_ENCODED_LEN byte frame holding the encoded
+        newest eligible release (see prodVersionLatestResolve), or all zeroes if
+        no update applies or the request failed strict decoding. Requests may be
+        pipelined; all responses for one read are written back as a single batch.
+
+    Build:  cc -O2 -std=c99 -I.. prodversiond.c -o prodversiond
+    Usage:  prodversiond -c catalog.bin [-u socket_path] [-p tcp_port]
+*/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "prodversion_latest.h"
+
+/// Frames processed per read, also bounds the batched response size
+#define PRODVERD_BATCH_FRAMES         256
+#define PRODVERD_MAX_EVENTS           64
+#define PRODVERD_LISTEN_BACKLOG       128
+
+typedef struct {
+    int fd;
+
+    /// @brief Partial request frame carried over between reads
+    char in[PRODVER_ENCODED_LEN * PRODVERD_BATCH_FRAMES];
+    size_t inLen;
+
+    /// @brief Responses not yet accepted by the socket
+    char out[PRODVER_ENCODED_LEN * PRODVERD_BATCH_FRAMES];
+    size_t outLen;
+    size_t outSent;
+
+    /// @brief True while registered for EPOLLOUT instead of EPOLLIN
+    bool waitingOut;
+} prodVersionConn_t;
+
+static prodVersionLatest_t catalog;
+static volatile sig_atomic_t running = 1;
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    running = 0;
+}
+
+/// @brief Loads every valid record of a catalog file into the latest-release view.
+static bool loadCatalog(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0) {
+        perror(path);
+        fclose(f);
+        return false;
+    }
+
+    //  Products never outnumber records, keep the index table at most half full
+    size_t records = (size_t)st.st_size / PRODVER_ENCODED_LEN;
+    size_t slotCount = 16;
+    while (slotCount < records * 2) {
+        slotCount <<= 1;
+    }
+
+    //  Entries are large and products usually few, so they grow as products are seen
+    size_t entryCapacity = 16;
+    uint32_t* slots = malloc(slotCount * sizeof(uint32_t));
+    prodVersionLatestEntry_t* entries = malloc(entryCapacity * sizeof(prodVersionLatestEntry_t));
+    if (!slots || !entries || !prodVersionLatestInit(&catalog, entries, entryCapacity, slots, slotCount)) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        free(slots);
+        free(entries);
+        fclose(f);
+        return false;
+    }
+
+    char buf[PRODVER_ENCODED_LEN];
+    size_t index = 0;
+    size_t rejected = 0;
+    while (fread(buf, 1, sizeof(buf), f) == sizeof(buf)) {
+        if (catalog.count == catalog.entryCapacity) {
+            size_t grown = catalog.entryCapacity * 2;
+            prodVersionLatestEntry_t* moved = realloc(catalog.entries, grown * sizeof(prodVersionLatestEntry_t));
+            if (!moved) {
+                fprintf(stderr, "%s: out of memory\n", path);
+                fclose(f);
+                return false;
+            }
+            catalog.entries = moved;
+            catalog.entryCapacity = grown;
+        }
+
+        prodVersion_t release;
+        prodVersionDecodeResult_t res = prodVersionDecodeBytesStrict(buf, sizeof(buf), &release);
+        if (res != PRODVER_DECODE_OK || !prodVersionLatestIngest(&catalog, &release, NULL)) {
+            fprintf(stderr, "%s: skipping record %zu (error %d)\n", path, index, (int)res);
+            rejected++;
+        }
+        index++;
+    }
+
+    fclose(f);
+    fprintf(stderr, "%s: loaded %zu records, %zu products, %zu rejected\n", path, index - rejected, catalog.count, rejected);
+    return true;
+}
+
+static int listenUnix(const char* path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: socket path too long\n", path);
+        return -1;
+    }
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, PRODVERD_LISTEN_BACKLOG) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int listenTcp(uint16_t port)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, PRODVERD_LISTEN_BACKLOG) != 0) {
+        perror("tcp");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void closeConn(int epfd, prodVersionConn_t* conn)
+{
+    epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn);
+}
+
+/// @brief Switches the connection between EPOLLIN and EPOLLOUT, skipping the syscall if already set.
+/// @return False if the connection failed.
+static bool watchConn(int epfd, prodVersionConn_t* conn, bool waitOut)
+{
+    if (conn->waitingOut == waitOut) {
+        return true;
+    }
+
+    struct epoll_event ev = { .events = waitOut ? EPOLLOUT : EPOLLIN, .data.ptr = conn };
+    if (epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev) != 0) {
+        return false;
+    }
+    conn->waitingOut = waitOut;
+    return true;
+}
+
+/// @brief Writes pending responses, switching to EPOLLOUT if the socket is full.
+/// @return False if the connection failed.
+static bool flushConn(int epfd, prodVersionConn_t* conn)
+{
+    while (conn->outSent < conn->outLen) {
+        ssize_t n = write(conn->fd, conn->out + conn->outSent, conn->outLen - conn->outSent);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+
+            return watchConn(epfd, conn, true);
+        }
+        conn->outSent += (size_t)n;
+    }
+
+    conn->outLen = 0;
+    conn->outSent = 0;
+    return watchConn(epfd, conn, false);
+}
+
+/// @brief Answers every complete frame in the input buffer into the output buffer.
+static void answerFrames(prodVersionConn_t* conn)
+{
+    size_t frames = conn->inLen / PRODVER_ENCODED_LEN;
+
+    for (size_t i = 0; i < frames; i++) {
+        const char* req = conn->in + i * PRODVER_ENCODED_LEN;
+        char* resp = conn->out + conn->outLen;
+        conn->outLen += PRODVER_ENCODED_LEN;
+
+        prodVersion_t device;
+        const prodVersion_t* update = NULL;
+        if (prodVersionDecodeBytesStrict(req, PRODVER_ENCODED_LEN, &device) == PRODVER_DECODE_OK) {
+            update = prodVersionLatestResolve(&catalog, &device);
+        }
+
+        if (!update || prodVersionEncodeBytes(resp, PRODVER_ENCODED_LEN, update) == 0) {
+            memset(resp, 0, PRODVER_ENCODED_LEN);
+        }
+    }
+
+    //  Keep any trailing partial frame for the next read
+    size_t used = frames * PRODVER_ENCODED_LEN;
+    memmove(conn->in, conn->in + used, conn->inLen - used);
+    conn->inLen -= used;
+}
+
+/// @brief Reads pipelined requests and writes their batched responses.
+/// @return False if the connection closed or failed.
+static bool serviceConn(int epfd, prodVersionConn_t* conn)
+{
+    //  Responses still pending, wait for EPOLLOUT before reading more
+    if (conn->outLen > 0) {
+        return flushConn(epfd, conn);
+    }
+
+    for (;;) {
+        ssize_t n = read(conn->fd, conn->in + conn->inLen, sizeof(conn->in) - conn->inLen);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        conn->inLen += (size_t)n;
+        answerFrames(conn);
+
+        if (!flushConn(epfd, conn)) {
+            return false;
+        }
+        if (conn->outLen > 0) {
+            return true;
+        }
+    }
+}
+
+static void acceptConns(int epfd, int lfd, bool tcp)
+{
+    for (;;) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("accept");
+            }
+            return;
+        }
+
+        //  Responses are small, don't let Nagle hold them back
+        if (tcp) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        prodVersionConn_t* conn = malloc(sizeof(prodVersionConn_t));
+        if (!conn) {
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->inLen = 0;
+        conn->outLen = 0;
+        conn->outSent = 0;
+        conn->waitingOut = false;
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = conn };
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(conn);
+        }
+    }
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr, "Usage: %s -c catalog.bin [-u socket_path] [-p tcp_port]\n", argv0);
+}
+
+/// @brief Parses a TCP port, the whole string must be a number in 1-65535.
+/// @return The port, or -1 if invalid.
+static long parsePort(const char* str)
+{
+    char* end;
+    long port = strtol(str, &end, 10);
+    return (end != str && *end == '\0' && port >= 1 && port <= 65535) ? port : -1;
+}
+
+int main(int argc, char** argv)
+{
+    const char* catalogPath = NULL;
+    const char* unixPath = NULL;
+    long tcpPort = -1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:u:p:")) != -1) {
+        switch (opt) {
+            case 'c': catalogPath = optarg; break;
+            case 'u': unixPath = optarg; break;
+            case 'p':
+                tcpPort = parsePort(optarg);
+                if (tcpPort < 0) {
+                    fprintf(stderr, "invalid port: %s\n", optarg);
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            default:  usage(argv[0]); return 2;
+        }
+    }
+
+    if (!catalogPath || (!unixPath && tcpPort < 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (!loadCatalog(catalogPath)) {
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    int listeners[2] = { -1, -1 };
+    if (unixPath) {
+        listeners[0] = listenUnix(unixPath);
+        if (listeners[0] < 0) {
+            return 1;
+        }
+    }
+    if (tcpPort >= 0) {
+        listeners[1] = listenTcp((uint16_t)tcpPort);
+        if (listeners[1] < 0) {
+            return 1;
+        }
+    }
+
+    //  Listening sockets are tagged by fd in data.u64 with the high bit set (and bit 62 for TCP), connections by pointer
+    for (int i = 0; i < 2; i++) {
+        if (listeners[i] < 0) {
+            continue;
+        }
+        uint64_t tag = (1ull << 63) | ((i == 1) ? (1ull << 62) : 0) | (uint64_t)listeners[i];
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = tag };
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, listeners[i], &ev) != 0) {
+            perror("epoll_ctl");
+            return 1;
+        }
+    }
+
+    struct epoll_event events[PRODVERD_MAX_EVENTS];
+    while (running) {
+        int n = epoll_wait(epfd, events, PRODVERD_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.u64 & (1ull << 63)) {
+                acceptConns(epfd, (int)(events[i].data.u64 & 0xFFFFFFFFu), (events[i].data.u64 & (1ull << 62)) != 0);
+                continue;
+            }
+
+            prodVersionConn_t* conn = events[i].data.ptr;
+            if ((events[i].events & EPOLLERR) || !serviceConn(epfd, conn)) {
+                closeConn(epfd, conn);
+            }
+        }
+    }
+
+    if (unixPath) {
+        unlink(unixPath);
+    }
+    free(catalog.entries);
+    free(catalog.slots);
+    close(epfd);
+    return 0;
+}
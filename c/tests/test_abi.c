@@ -0,0 +1,77 @@
+/*
+    Production Version - Shared Library Smoke Test
+    Nick Daria (contact@nickdaria.com)
+
+    Links against libprodversion and calls each exported function through the
+    C ABI only, the way FFI consumers do. Run by ctest.
+*/
+
+#include "libprodversion/libprodversion.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); return 1; } } while (0)
+
+#define RECORDS        5
+
+int main(void)
+{
+    CHECK(prodVersionAbiVersion() == PRODVER_ABI_VERSION);
+    CHECK(prodVersionAbiStructSize() == sizeof(prodVersion_t));
+
+    prodVersion_t versions[RECORDS];
+    memset(versions, 0, sizeof(versions));
+    for (int i = 0; i < RECORDS; i++) {
+        strcpy(versions[i].product, "abi-smoke");
+        strcpy(versions[i].metadata, "stripped");
+        strcpy(versions[i].commitHash, "7b5a2fe");
+        versions[i].major = 1;
+        versions[i].minor = (uint16_t)i;
+        versions[i].releaseChannel = (i % 2) ? VERSION_CHANNEL_RELEASE : VERSION_CHANNEL_BETA;
+        versions[i].date = 1700000000ull + (uint64_t)i;
+    }
+
+    //  Single record round trip
+    char encoded[PRODVER_ENCODED_LEN];
+    prodVersion_t decoded;
+    CHECK(prodVersionAbiEncode(encoded, sizeof(encoded), &versions[0]) == PRODVER_ENCODED_LEN);
+    CHECK(prodVersionAbiDecode(encoded, sizeof(encoded), &decoded));
+    CHECK(prodVersionAbiDecodeStrict(encoded, sizeof(encoded), &decoded) == PRODVER_DECODE_OK);
+    CHECK(prodVersionAbiCompare(&decoded, &versions[0]) == 0);
+    CHECK(strcmp(decoded.product, "abi-smoke") == 0);
+    CHECK(prodVersionAbiEncode(encoded, sizeof(encoded) - 1, &versions[0]) == 0);
+
+    char str[64];
+    CHECK(prodVersionAbiToString(&decoded, str, sizeof(str)) == strlen(str));
+    CHECK(strcmp(str, "abi-smoke 1.0.0b-stripped (7b5a2fe)") == 0);
+
+    CHECK(prodVersionAbiChannelEligible(VERSION_CHANNEL_BETA, VERSION_CHANNEL_RELEASE));
+    CHECK(!prodVersionAbiChannelEligible(VERSION_CHANNEL_RELEASE, VERSION_CHANNEL_BETA));
+
+    //  Batches, with one corrupted record
+    char buf[RECORDS * PRODVER_ENCODED_LEN];
+    CHECK(prodVersionAbiEncodeBatch(buf, versions, RECORDS) == RECORDS);
+    buf[2 * PRODVER_ENCODED_LEN] = (char)(PRODVER_STRUCTVER + 1);
+
+    prodVersion_t batch[RECORDS];
+    uint8_t ok[RECORDS];
+    CHECK(prodVersionAbiDecodeBatch(buf, RECORDS, batch, ok) == RECORDS - 1);
+    for (int i = 0; i < RECORDS; i++) {
+        CHECK(ok[i] == (i != 2));
+        CHECK(i == 2 || prodVersionAbiCompare(&batch[i], &versions[i]) == 0);
+    }
+
+    uint64_t keys[RECORDS];
+    uint64_t dates[RECORDS];
+    prodVersionAbiPeekSemverBatch(buf, RECORDS, keys);
+    prodVersionAbiPeekDateBatch(buf, RECORDS, dates);
+    CHECK(keys[3] == prodVersionPackSemver(&versions[3]));
+    CHECK(dates[4] == versions[4].date);
+
+    //  Release builds newer than 1.1, as a release device sees them
+    uint8_t match[RECORDS];
+    size_t matches = prodVersionAbiFilterBatch(buf, RECORDS, prodVersionPackSemver(&versions[1]), prodVersionChannelAccepts(VERSION_CHANNEL_RELEASE), match);
+    CHECK(matches == 1);
+    CHECK(match[3] && !match[1] && !match[4]);
+
+    printf("libprodversion ABI %u smoke test passed\n", (unsigned)prodVersionAbiVersion());
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+    Production Version - Columnar Archive Test
+    Nick Daria (contact@nickdaria.com)
+
+    Checks prodversion_archive.h, run by ctest:
+        - random blocks decode back to the canonical form of their records
+        - a worst-case block (every string distinct and full length, every
+          column at full width) fits PRODVER_ARCHIVE_MAX_LEN exactly sized
+        - blocks whose columns hold values too wide for their field are rejected
+
+    Usage:  test_archive [blocks] [seed]
+*/
+
+#include <stdlib.h>
+
+#include "prodversion_archive.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); return 1; } } while (0)
+
+static uint64_t rngState;
+
+static uint64_t rng(void)
+{
+    //  xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+/// @brief Fills a string field with length characters, then garbage after a terminator when shorter.
+static void randomField(char* field, const size_t fieldLen, const size_t length, const bool garbage)
+{
+    for (size_t i = 0; i < fieldLen; i++) {
+        field[i] = (char)(garbage ? rng() : 0);
+    }
+    for (size_t i = 0; i < length; i++) {
+        field[i] = (char)('!' + rng() % 94);
+    }
+    if (length < fieldLen) {
+        field[length] = '\0';
+    }
+}
+
+/// @brief Random record, drawing strings from small pools so dictionaries repeat.
+static void randomRecord(char* rec)
+{
+    for (size_t i = 0; i < PRODVER_ENCODED_LEN; i++) {
+        rec[i] = (char)rng();
+    }
+    rec[PRODVER_OFS_STRUCTVER] = PRODVER_STRUCTVER;
+
+    uint64_t saved = rngState;
+    rngState = 1 + rng() % 8;
+    randomField(rec + PRODVER_OFS_PRODUCT, PRODVER_FLD_PRODUCT_LEN, 1 + rng() % PRODVER_FLD_PRODUCT_LEN, false);
+    rngState = saved;
+    randomField(rec + PRODVER_OFS_METADATA, PRODVER_FLD_METADATA_LEN, rng() % (PRODVER_FLD_METADATA_LEN + 1), true);
+    randomField(rec + PRODVER_OFS_COMMIT, PRODVER_FLD_COMMIT_LEN, rng() % (PRODVER_FLD_COMMIT_LEN + 1), true);
+}
+
+/// @brief Offset of a column's 9-byte header within a block, walking the dictionaries.
+static size_t columnOffset(const char* block, const size_t count, const int column)
+{
+    size_t offset = PRODVER_ARCHIVE_HEADER_LEN;
+    for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+        uint64_t entries = prodVersionArchiveReadBE(block + offset, 2);
+        offset += 2;
+        for (uint64_t e = 0; e < entries; e++) {
+            offset += 1 + (uint8_t)block[offset];
+        }
+    }
+    for (int c = 0; c < column; c++) {
+        offset += 9 + prodVersionArchivePackedLen(count, (uint8_t)block[offset + 8]);
+    }
+    return offset;
+}
+
+static int checkRoundTrip(prodVersionArchiveWork_t* work, char* records, char* decoded, char* block, const unsigned long blocks)
+{
+    for (unsigned long b = 0; b < blocks; b++) {
+        size_t count = 1 + (size_t)(rng() % PRODVER_ARCHIVE_BLOCK_RECORDS);
+        for (size_t i = 0; i < count; i++) {
+            randomRecord(records + i * PRODVER_ENCODED_LEN);
+        }
+
+        size_t len = prodVersionArchiveEncodeBlock(work, records, count, block, PRODVER_ARCHIVE_MAX_LEN(count));
+        CHECK(len > 0 && len <= PRODVER_ARCHIVE_MAX_LEN(count));
+
+        size_t got = 0;
+        CHECK(prodVersionArchiveDecodeBlock(work, block, len, decoded, count, &got));
+        CHECK(got == count);
+        CHECK(!prodVersionArchiveDecodeBlock(work, block, len - 1, decoded, count, &got));
+
+        for (size_t i = 0; i < count; i++) {
+            char* rec = records + i * PRODVER_ENCODED_LEN;
+            CHECK(prodVersionCanonicalizeBytes(rec, PRODVER_ENCODED_LEN));
+            CHECK(memcmp(rec, decoded + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN) == 0);
+        }
+    }
+    return 0;
+}
+
+static int checkWorstCase(prodVersionArchiveWork_t* work, char* records, char* decoded, char* block)
+{
+    const size_t count = PRODVER_ARCHIVE_BLOCK_RECORDS;
+
+    //  Distinct full-length strings (index prefix keeps them unique), values spanning every bit
+    for (size_t i = 0; i < count; i++) {
+        char* rec = records + i * PRODVER_ENCODED_LEN;
+        for (size_t b = 0; b < PRODVER_ENCODED_LEN; b++) {
+            rec[b] = (char)('!' + rng() % 94);
+        }
+        rec[PRODVER_OFS_STRUCTVER] = PRODVER_STRUCTVER;
+        for (int d = 0; d < PRODVER_ARCHIVE_DICTS; d++) {
+            size_t offset;
+            size_t fieldLen;
+            prodVersionArchiveDictField(d, &offset, &fieldLen);
+            snprintf(rec + offset, fieldLen, "%04zx", i);
+            rec[offset + 4] = 'x';
+        }
+        uint16_t fill = (i & 1) ? 0xFFFF : 0;
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_MAJOR, fill, 2);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_MINOR, fill, 2);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_PATCH, fill, 2);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_BUILD, fill, 2);
+        rec[PRODVER_OFS_CHANNEL] = (char)((i & 1) ? 0xFF : 0);
+        prodVersionArchiveWriteBE(rec + PRODVER_OFS_DATE, (i & 1) ? UINT64_MAX : 0, 8);
+    }
+
+    size_t len = prodVersionArchiveEncodeBlock(work, records, count, block, PRODVER_ARCHIVE_MAX_LEN(count));
+    CHECK(len > 0);
+    CHECK(len <= PRODVER_ARCHIVE_MAX_LEN(count));
+    CHECK(len > PRODVER_ARCHIVE_MAX_LEN(count) - 64);
+    CHECK(prodVersionArchiveEncodeBlock(work, records, count, block, len - 1) == 0);
+
+    size_t got = 0;
+    CHECK(prodVersionArchiveDecodeBlock(work, block, len, decoded, count, &got) && got == count);
+    CHECK(memcmp(records, decoded, count * PRODVER_ENCODED_LEN) == 0);
+    printf("worst case %zu records: %zu bytes (bound %zu)\n", count, len, (size_t)PRODVER_ARCHIVE_MAX_LEN(count));
+    return 0;
+}
+
+static int checkMalformed(prodVersionArchiveWork_t* work, char* records, char* decoded, char* block)
+{
+    const size_t count = 16;
+    for (size_t i = 0; i < count; i++) {
+        randomRecord(records + i * PRODVER_ENCODED_LEN);
+    }
+
+    size_t len = prodVersionArchiveEncodeBlock(work, records, count, block, PRODVER_ARCHIVE_MAX_LEN(count));
+    CHECK(len > 0);
+
+    char* bad = malloc(len);
+    CHECK(bad);
+    size_t got = 0;
+
+    //  Column bases past what their fields hold
+    static const struct { int column; uint64_t base; } cases[] = {
+        { PRODVER_ARCHIVE_COL_CHANNEL, 0x100 },
+        { PRODVER_ARCHIVE_COL_MAJOR, 0x10000 },
+        { PRODVER_ARCHIVE_COL_BUILD, UINT64_MAX },
+    };
+    bool rejected = true;
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        memcpy(bad, block, len);
+        prodVersionArchiveWriteBE(bad + columnOffset(bad, count, cases[k].column), cases[k].base, 8);
+        rejected &= !prodVersionArchiveDecodeBlock(work, bad, len, decoded, count, &got) && got == 0;
+    }
+
+    //  Dictionary index past the dictionary
+    memcpy(bad, block, len);
+    prodVersionArchiveWriteBE(bad + columnOffset(bad, count, PRODVER_ARCHIVE_COL_PRODUCT), count, 8);
+    rejected &= !prodVersionArchiveDecodeBlock(work, bad, len, decoded, count, &got);
+    free(bad);
+    CHECK(rejected);
+
+    //  Unmodified block still decodes
+    CHECK(prodVersionArchiveDecodeBlock(work, block, len, decoded, count, &got) && got == count);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long blocks = (argc > 1) ? strtoul(argv[1], NULL, 10) : 50;
+    rngState = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0x9E3779B97F4A7C15ull;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+
+    prodVersionArchiveWork_t* work = malloc(sizeof(prodVersionArchiveWork_t));
+    char* records = malloc((size_t)PRODVER_ARCHIVE_BLOCK_RECORDS * PRODVER_ENCODED_LEN);
+    char* decoded = malloc((size_t)PRODVER_ARCHIVE_BLOCK_RECORDS * PRODVER_ENCODED_LEN);
+    char* block = malloc(PRODVER_ARCHIVE_MAX_LEN(PRODVER_ARCHIVE_BLOCK_RECORDS));
+    if (!work || !records || !decoded || !block) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    int ret = checkRoundTrip(work, records, decoded, block, blocks) ||
+              checkWorstCase(work, records, decoded, block) ||
+              checkMalformed(work, records, decoded, block);
+    if (!ret) {
+        printf("%lu random blocks passed\n", blocks);
+    }
+
+    free(work);
+    free(records);
+    free(decoded);
+    free(block);
+    return ret;
+}
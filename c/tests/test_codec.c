@@ -0,0 +1,285 @@
+/*
+    Production Version - Codec Round-Trip Test
+    Nick Daria (contact@nickdaria.com)
+
+    Randomized property checks on the codec, run by ctest:
+        - encode writes exactly 64 bytes and decode returns the same fields
+        - encode(decode(x)) equals prodVersionCanonicalizeBytes(x) for arbitrary bytes
+        - strict decode agrees with the regular decoder whenever it accepts
+        - prodVersionToString never overruns or leaves an unterminated string
+        - prodVersionToString gives the expected text for known versions
+
+    Then a throughput gate on encode + decode. A baseline loop that only
+    copies the same 64 bytes per record in and out is timed alongside, and
+    the gate fails when the codec is more than PRODVER_PERF_MAX_RATIO times
+    slower than that baseline (0 disables the gate), so the threshold holds
+    across machines and load.
+
+    Usage:  test_codec [iterations] [seed]
+*/
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "prodversion.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s (iteration %lu)\n", __FILE__, __LINE__, #cond, iteration); return 1; } } while (0)
+
+/// Default limit on codec time over baseline time; about 5x is typical, optimized or not
+#define PERF_MAX_RATIO_DEFAULT        20.0
+#define PERF_RECORDS                  200000
+
+static uint64_t rngState;
+static unsigned long iteration;
+
+static uint64_t rng(void)
+{
+    //  xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+static void randomString(char* str, const size_t maxLen)
+{
+    size_t len = (size_t)(rng() % (maxLen + 1));
+    for (size_t i = 0; i < len; i++) {
+        str[i] = (char)(' ' + rng() % 95);
+    }
+    str[len] = '\0';
+}
+
+static void randomVersion(prodVersion_t* version)
+{
+    static const char channels[] = "diabcrf";
+
+    memset(version, 0, sizeof(prodVersion_t));
+    randomString(version->product, PRODVER_FLD_PRODUCT_LEN);
+    randomString(version->metadata, PRODVER_FLD_METADATA_LEN);
+    randomString(version->commitHash, PRODVER_FLD_COMMIT_LEN);
+    version->major = (uint16_t)rng();
+    version->minor = (uint16_t)rng();
+    version->patch = (uint16_t)rng();
+    version->build = (uint16_t)rng();
+    version->releaseChannel = (prodVersionChannel_t)channels[rng() % 7];
+    version->date = rng();
+}
+
+static int checkRoundTrip(void)
+{
+    prodVersion_t version;
+    prodVersion_t decoded;
+    char encoded[PRODVER_ENCODED_LEN];
+    char again[PRODVER_ENCODED_LEN];
+
+    randomVersion(&version);
+    CHECK(prodVersionEncodeBytes(encoded, sizeof(encoded), &version) == PRODVER_ENCODED_LEN);
+    CHECK(prodVersionDecodeBytes(encoded, sizeof(encoded), &decoded));
+    CHECK(prodVersionDecodeBytesStrict(encoded, sizeof(encoded), &decoded) == PRODVER_DECODE_OK);
+
+    CHECK(strcmp(decoded.product, version.product) == 0);
+    CHECK(strcmp(decoded.metadata, version.metadata) == 0);
+    CHECK(strcmp(decoded.commitHash, version.commitHash) == 0);
+    CHECK(prodVersionCompare(&decoded, &version) == 0);
+    CHECK(decoded.releaseChannel == version.releaseChannel);
+    CHECK(decoded.date == version.date);
+    CHECK(prodVersionPeekSemver(encoded) == prodVersionPackSemver(&version));
+    CHECK(prodVersionPeekDate(encoded) == version.date);
+
+    CHECK(prodVersionEncodeBytes(again, sizeof(again), &decoded) == PRODVER_ENCODED_LEN);
+    CHECK(memcmp(encoded, again, PRODVER_ENCODED_LEN) == 0);
+    return 0;
+}
+
+static int checkArbitraryBytes(void)
+{
+    char raw[PRODVER_ENCODED_LEN];
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (char)rng();
+    }
+
+    //  Mostly valid structure versions, with NULs sprinkled in so fields terminate early
+    if (rng() % 8) {
+        raw[0] = PRODVER_STRUCTVER;
+    }
+    for (int i = 0; i < 4; i++) {
+        raw[1 + rng() % (PRODVER_ENCODED_LEN - 1)] = '\0';
+    }
+
+    prodVersion_t version;
+    prodVersion_t strict;
+    bool ok = prodVersionDecodeBytes(raw, sizeof(raw), &version);
+    prodVersionDecodeResult_t strictRes = prodVersionDecodeBytesStrict(raw, sizeof(raw), &strict);
+    CHECK(ok == ((uint8_t)raw[0] == PRODVER_STRUCTVER));
+    if (!ok) {
+        CHECK(strictRes == PRODVER_DECODE_ERR_STRUCTVER);
+        return 0;
+    }
+
+    char encoded[PRODVER_ENCODED_LEN];
+    char canonical[PRODVER_ENCODED_LEN];
+    CHECK(prodVersionEncodeBytes(encoded, sizeof(encoded), &version) == PRODVER_ENCODED_LEN);
+    memcpy(canonical, raw, sizeof(raw));
+    CHECK(prodVersionCanonicalizeBytes(canonical, sizeof(canonical)));
+    CHECK(memcmp(encoded, canonical, PRODVER_ENCODED_LEN) == 0);
+
+    if (strictRes == PRODVER_DECODE_OK) {
+        char strictEncoded[PRODVER_ENCODED_LEN];
+        CHECK(prodVersionEncodeBytes(strictEncoded, sizeof(strictEncoded), &strict) == PRODVER_ENCODED_LEN);
+        CHECK(memcmp(strictEncoded, encoded, PRODVER_ENCODED_LEN) == 0);
+    }
+
+    //  Formatting at a random buffer size, with a guard byte past the end
+    char str[128];
+    size_t len = 1 + (size_t)(rng() % (sizeof(str) - 1));
+    str[len] = 0x5A;
+    size_t written = prodVersionToString(&version, str, len);
+    CHECK(str[len] == 0x5A);
+    CHECK(written < len);
+    CHECK(str[written] == '\0');
+    return 0;
+}
+
+static int checkToString(void)
+{
+    static const struct {
+        const char* product;
+        uint16_t major, minor, patch, build;
+        prodVersionChannel_t channel;
+        const char* metadata;
+        const char* commit;
+        const char* expected;
+    } cases[] = {
+        { "MYPRODUCT", 1, 2, 3, 42, VERSION_CHANNEL_ALPHA, "something", "abc1234", "MYPRODUCT 1.2.3a-something (abc1234) build 42" },
+        { "gateway", 10, 0, 65535, 0, VERSION_CHANNEL_RELEASE, "", "7b5a2fe", "gateway 10.0.65535r" },
+        { "sensor", 0, 9, 1, 1, VERSION_CHANNEL_RELEASE, "5CW3C", "", "sensor 0.9.1r-5CW3C build 1" },
+        { "bootloader", 2, 0, 0, 0, VERSION_CHANNEL_FACTORY, "", "", "bootloader 2.0.0f ()" },
+    };
+
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        prodVersion_t version;
+        memset(&version, 0, sizeof(version));
+        strcpy(version.product, cases[k].product);
+        strcpy(version.metadata, cases[k].metadata);
+        strcpy(version.commitHash, cases[k].commit);
+        version.major = cases[k].major;
+        version.minor = cases[k].minor;
+        version.patch = cases[k].patch;
+        version.build = cases[k].build;
+        version.releaseChannel = cases[k].channel;
+
+        //  Through the codec, then formatted into an exact-size buffer and one byte short
+        char encoded[PRODVER_ENCODED_LEN];
+        prodVersion_t decoded;
+        CHECK(prodVersionEncodeBytes(encoded, sizeof(encoded), &version) == PRODVER_ENCODED_LEN);
+        CHECK(prodVersionDecodeBytes(encoded, sizeof(encoded), &decoded));
+
+        char str[64];
+        size_t len = strlen(cases[k].expected);
+        CHECK(prodVersionToString(&decoded, str, len + 1) == len);
+        CHECK(strcmp(str, cases[k].expected) == 0);
+        CHECK(prodVersionToString(&decoded, str, len) == 0 && str[0] == '\0');
+    }
+    return 0;
+}
+
+/// @brief Seconds of CPU time for one encode + decode pass, or for the baseline copying the same bytes.
+static double timePass(const prodVersion_t* versions, char* buf, const bool codec, uint64_t* sink)
+{
+    clock_t start = clock();
+    if (codec) {
+        for (size_t i = 0; i < PERF_RECORDS; i++) {
+            prodVersionEncodeBytes(buf + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &versions[i]);
+        }
+        for (size_t i = 0; i < PERF_RECORDS; i++) {
+            prodVersion_t version;
+            if (prodVersionDecodeBytes(buf + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &version)) {
+                *sink += version.build;
+            }
+        }
+    } else {
+        for (size_t i = 0; i < PERF_RECORDS; i++) {
+            memcpy(buf + i * PRODVER_ENCODED_LEN, &versions[i], PRODVER_ENCODED_LEN);
+        }
+        for (size_t i = 0; i < PRODVER_ENCODED_LEN / 8 * PERF_RECORDS; i++) {
+            uint64_t word;
+            memcpy(&word, buf + i * 8, 8);
+            *sink += word;
+        }
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int checkThroughput(void)
+{
+    double maxRatio = PERF_MAX_RATIO_DEFAULT;
+    const char* env = getenv("PRODVER_PERF_MAX_RATIO");
+    if (env) {
+        maxRatio = strtod(env, NULL);
+    }
+    if (maxRatio <= 0) {
+        printf("throughput gate disabled\n");
+        return 0;
+    }
+
+    prodVersion_t* versions = malloc(PERF_RECORDS * sizeof(prodVersion_t));
+    char* buf = malloc((size_t)PERF_RECORDS * PRODVER_ENCODED_LEN);
+    if (!versions || !buf) {
+        free(versions);
+        free(buf);
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < PERF_RECORDS; i++) {
+        randomVersion(&versions[i]);
+    }
+
+    //  Interleaved, best of several passes each, so load and frequency changes hit both alike
+    double codec = 0;
+    double baseline = 0;
+    uint64_t sink = 0;
+    for (int pass = 0; pass < 7; pass++) {
+        double b = timePass(versions, buf, false, &sink);
+        double c = timePass(versions, buf, true, &sink);
+        if (pass == 0 || b < baseline) {
+            baseline = b;
+        }
+        if (pass == 0 || c < codec) {
+            codec = c;
+        }
+    }
+
+    free(versions);
+    free(buf);
+
+    //  A baseline too fast for the clock counts as one tick
+    double tick = 1.0 / CLOCKS_PER_SEC;
+    double ratio = codec / (baseline > tick ? baseline : tick);
+    printf("encode + decode: %.0f records/s, %.1fx the copy baseline (limit %.1fx, sink %llu)\n",
+           PERF_RECORDS / (codec > tick ? codec : tick), ratio, maxRatio, (unsigned long long)sink);
+    if (ratio > maxRatio) {
+        fprintf(stderr, "throughput too far below the copy baseline\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : 200000;
+    rngState = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0x9E3779B97F4A7C15ull;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+
+    for (iteration = 0; iteration < iterations; iteration++) {
+        if (checkRoundTrip() || checkArbitraryBytes()) {
+            return 1;
+        }
+    }
+    printf("%lu round-trip iterations passed\n", iterations);
+
+    return checkToString() || checkThroughput();
+}
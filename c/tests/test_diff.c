@@ -0,0 +1,225 @@
+/*
+    Production Version - Fleet Diff Test
+    Nick Daria (contact@nickdaria.com)
+
+    Checks prodversion_diff.h against a model working on decoded versions,
+    run by ctest:
+        - hand-picked pairs classify as upgraded, downgraded, changed, and as
+          unchanged when they differ only in bytes after a string terminator
+        - random snapshots with interleaved, partly shared device IDs merge-join
+          into the same added, removed and per-device kinds as the model, with
+          the callback seeing each non-unchanged device once, in ID order
+
+    Usage:  test_diff [devices] [seed]
+*/
+
+#include <stdlib.h>
+
+#include "prodversion_diff.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); return 1; } } while (0)
+
+#define VERSIONS       12
+
+static uint64_t rngState;
+
+static uint64_t rng(void)
+{
+    //  xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+static void makeVersion(prodVersion_t* version, const char* product, const uint16_t minor, const uint16_t build, const char* commit)
+{
+    memset(version, 0, sizeof(prodVersion_t));
+    snprintf(version->product, sizeof(version->product), "%s", product);
+    snprintf(version->commitHash, sizeof(version->commitHash), "%s", commit);
+    version->major = 1;
+    version->minor = minor;
+    version->build = build;
+    version->releaseChannel = VERSION_CHANNEL_RELEASE;
+    version->date = 1700000000ull;
+}
+
+/// @brief Encodes one of a few versions, with random garbage after the string terminators.
+static void makeEncoding(char* encoded, const unsigned index)
+{
+    prodVersion_t version;
+    makeVersion(&version, (index % 3) ? "diff-a" : "diff-b", (uint16_t)(index / 4), (uint16_t)(index % 2), (index % 5) ? "1111111" : "22");
+    prodVersionEncodeBytes(encoded, PRODVER_ENCODED_LEN, &version);
+
+    for (size_t i = PRODVER_OFS_PRODUCT + 7; i < PRODVER_OFS_PRODUCT + PRODVER_FLD_PRODUCT_LEN; i++) {
+        encoded[i] = (char)(rng() % 3 ? 0 : rng());
+    }
+    for (size_t i = PRODVER_OFS_METADATA; i < PRODVER_OFS_METADATA + PRODVER_FLD_METADATA_LEN; i++) {
+        encoded[i] = (char)((i > PRODVER_OFS_METADATA && rng() % 2) ? rng() : 0);
+    }
+}
+
+/// @brief Model of prodVersionDiffClassify over decoded versions.
+static prodVersionDiffKind_t modelClassify(const char* before, const char* after)
+{
+    prodVersion_t a;
+    prodVersion_t b;
+    prodVersionDecodeBytes(before, PRODVER_ENCODED_LEN, &a);
+    prodVersionDecodeBytes(after, PRODVER_ENCODED_LEN, &b);
+
+    if (strcmp(a.product, b.product) != 0) {
+        return PRODVER_DIFF_CHANGED;
+    }
+    int order = prodVersionCompare(&b, &a);
+    if (order) {
+        return (order > 0) ? PRODVER_DIFF_UPGRADED : PRODVER_DIFF_DOWNGRADED;
+    }
+    bool same = a.releaseChannel == b.releaseChannel && a.date == b.date &&
+                strcmp(a.metadata, b.metadata) == 0 && strcmp(a.commitHash, b.commitHash) == 0;
+    return same ? PRODVER_DIFF_UNCHANGED : PRODVER_DIFF_CHANGED;
+}
+
+static int checkPairs(void)
+{
+    char a[PRODVER_ENCODED_LEN];
+    char b[PRODVER_ENCODED_LEN];
+    prodVersion_t version;
+
+    makeVersion(&version, "diff-a", 4, 0, "1111111");
+    prodVersionEncodeBytes(a, sizeof(a), &version);
+
+    //  Padding-only difference after the product, metadata and commit terminators
+    memcpy(b, a, sizeof(b));
+    b[PRODVER_OFS_PRODUCT + 10] = 'x';
+    b[PRODVER_OFS_METADATA + 3] = 'y';
+    CHECK(!prodVersionEncodedEqual(a, b));
+    CHECK(prodVersionDiffClassify(a, b) == PRODVER_DIFF_UNCHANGED);
+
+    //  Higher build, lower minor, other commit, other product
+    version.build = 1;
+    prodVersionEncodeBytes(b, sizeof(b), &version);
+    CHECK(prodVersionDiffClassify(a, b) == PRODVER_DIFF_UPGRADED);
+    CHECK(prodVersionDiffClassify(b, a) == PRODVER_DIFF_DOWNGRADED);
+
+    makeVersion(&version, "diff-a", 4, 0, "2222222");
+    prodVersionEncodeBytes(b, sizeof(b), &version);
+    CHECK(prodVersionDiffClassify(a, b) == PRODVER_DIFF_CHANGED);
+
+    makeVersion(&version, "diff-b", 5, 0, "1111111");
+    prodVersionEncodeBytes(b, sizeof(b), &version);
+    CHECK(prodVersionDiffClassify(a, b) == PRODVER_DIFF_CHANGED);
+    return 0;
+}
+
+typedef struct {
+    const prodVersionFleetEntry_t* before;
+    const prodVersionFleetEntry_t* after;
+    size_t beforeCount;
+    size_t afterCount;
+    uint64_t calls;
+    uint64_t lastId;
+    bool bad;
+} diffCtx_t;
+
+static const prodVersionFleetEntry_t* findEntry(const prodVersionFleetEntry_t* entries, const size_t count, const uint64_t deviceId)
+{
+    prodVersionFleetEntry_t key;
+    key.deviceId = deviceId;
+    return bsearch(&key, entries, count, sizeof(prodVersionFleetEntry_t), prodVersionFleetEntryCompare);
+}
+
+static void onDiff(uint64_t deviceId, prodVersionDiffKind_t kind, const char* before, const char* after, void* ctx)
+{
+    diffCtx_t* diff = (diffCtx_t*)ctx;
+    const prodVersionFleetEntry_t* was = findEntry(diff->before, diff->beforeCount, deviceId);
+    const prodVersionFleetEntry_t* now = findEntry(diff->after, diff->afterCount, deviceId);
+
+    //  Pointers into the snapshots for this device, in strictly increasing ID order
+    bool ok = (diff->calls == 0 || deviceId > diff->lastId) &&
+              before == (was ? was->encoded : NULL) && after == (now ? now->encoded : NULL);
+    if (was && now) {
+        ok = ok && kind == modelClassify(before, after) && kind != PRODVER_DIFF_UNCHANGED;
+    } else {
+        ok = ok && kind == (was ? PRODVER_DIFF_REMOVED : PRODVER_DIFF_ADDED);
+    }
+
+    diff->bad |= !ok;
+    diff->lastId = deviceId;
+    diff->calls++;
+}
+
+static int checkSnapshots(const size_t devices)
+{
+    prodVersionFleetEntry_t* before = malloc(devices * sizeof(prodVersionFleetEntry_t));
+    prodVersionFleetEntry_t* after = malloc(devices * sizeof(prodVersionFleetEntry_t));
+    CHECK(before && after);
+
+    //  IDs spread out so the snapshots interleave; each device is in one or both
+    uint64_t want[PRODVER_DIFF_KINDS] = { 0 };
+    size_t beforeCount = 0;
+    size_t afterCount = 0;
+    uint64_t id = 0;
+    for (size_t d = 0; d < devices; d++) {
+        id += 1 + rng() % 1000;
+        unsigned presence = (unsigned)(rng() % 8);
+        unsigned version = (unsigned)(rng() % VERSIONS);
+        char* was = NULL;
+
+        if (presence != 0) {
+            before[beforeCount].deviceId = id;
+            makeEncoding(before[beforeCount].encoded, version);
+            was = before[beforeCount++].encoded;
+        }
+        if (presence != 1) {
+            after[afterCount].deviceId = id;
+            makeEncoding(after[afterCount].encoded, (rng() % 3) ? version : (unsigned)(rng() % VERSIONS));
+            want[was ? modelClassify(was, after[afterCount].encoded) : PRODVER_DIFF_ADDED]++;
+            afterCount++;
+        } else {
+            want[PRODVER_DIFF_REMOVED]++;
+        }
+    }
+
+    //  Shuffle, then let prodVersionFleetSort restore the order
+    for (size_t i = afterCount; i > 1; i--) {
+        size_t k = (size_t)(rng() % i);
+        prodVersionFleetEntry_t t = after[i - 1];
+        after[i - 1] = after[k];
+        after[k] = t;
+    }
+    prodVersionFleetSort(after, afterCount);
+
+    uint64_t got[PRODVER_DIFF_KINDS];
+    diffCtx_t ctx = { before, after, beforeCount, afterCount, 0, 0, false };
+    CHECK(prodVersionDiff(before, beforeCount, after, afterCount, got, onDiff, &ctx));
+    CHECK(!ctx.bad);
+    CHECK(ctx.calls == devices - want[PRODVER_DIFF_UNCHANGED]);
+    for (int k = 0; k < PRODVER_DIFF_KINDS; k++) {
+        CHECK(got[k] == want[k]);
+        CHECK(want[k] > 0);
+    }
+
+    //  Against an empty snapshot everything is added or removed
+    CHECK(prodVersionDiff(NULL, 0, after, afterCount, got, NULL, NULL) && got[PRODVER_DIFF_ADDED] == afterCount);
+    CHECK(prodVersionDiff(before, beforeCount, NULL, 0, got, NULL, NULL) && got[PRODVER_DIFF_REMOVED] == beforeCount);
+    CHECK(!prodVersionDiff(NULL, 1, after, afterCount, got, NULL, NULL));
+
+    printf("%zu devices: %llu unchanged, %llu upgraded, %llu downgraded, %llu changed, %llu added, %llu removed\n", devices,
+           (unsigned long long)want[PRODVER_DIFF_UNCHANGED], (unsigned long long)want[PRODVER_DIFF_UPGRADED],
+           (unsigned long long)want[PRODVER_DIFF_DOWNGRADED], (unsigned long long)want[PRODVER_DIFF_CHANGED],
+           (unsigned long long)want[PRODVER_DIFF_ADDED], (unsigned long long)want[PRODVER_DIFF_REMOVED]);
+    free(before);
+    free(after);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t devices = (argc > 1) ? strtoul(argv[1], NULL, 10) : 20000;
+    rngState = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0x9E3779B97F4A7C15ull;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+
+    return checkPairs() || checkSnapshots(devices);
+}
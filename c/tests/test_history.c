@@ -0,0 +1,253 @@
+/*
+    Production Version - Device History Test
+    Nick Daria (contact@nickdaria.com)
+
+    Checks prodversion_history.h against a brute-force model, run by ctest:
+        - reports appended in many batches answer prodVersionHistoryAt and
+          prodVersionHistoryLeft like a scan over every report, and like the
+          same reports built in one batch
+        - encodings differing only after a string terminator stay one stint
+        - a batch with a report older than its device's history, or one that
+          does not fit, is rejected without changing the history
+
+    Usage:  test_history [reports] [seed]
+*/
+
+#include <stdlib.h>
+
+#include "prodversion_history.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); return 1; } } while (0)
+
+#define DEVICES        37
+#define VERSIONS       5
+#define BATCHES        24
+
+static uint64_t rngState;
+
+static uint64_t rng(void)
+{
+    //  xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+/// @brief One of a few versions, with random garbage after the string terminators.
+static void makeEncoding(char* encoded, const unsigned version)
+{
+    prodVersion_t v;
+    memset(&v, 0, sizeof(v));
+    snprintf(v.product, sizeof(v.product), "dev");
+    snprintf(v.commitHash, sizeof(v.commitHash), "%07x", version * 0x1111u);
+    v.major = 1;
+    v.minor = (uint16_t)version;
+    v.releaseChannel = VERSION_CHANNEL_RELEASE;
+    v.date = 1700000000ull + version;
+    prodVersionEncodeBytes(encoded, PRODVER_ENCODED_LEN, &v);
+
+    for (size_t i = PRODVER_OFS_PRODUCT + 4; i < PRODVER_OFS_PRODUCT + PRODVER_FLD_PRODUCT_LEN; i++) {
+        encoded[i] = (char)(rng() % 3 ? 0 : rng());
+    }
+}
+
+typedef struct {
+    prodVersionHistory_t history;
+    prodVersionHistoryEntry_t* entries;
+    uint8_t* deltas;
+    prodVersionHistoryStint_t* stints;
+} store_t;
+
+static bool storeInit(store_t* store, const size_t reports)
+{
+    store->entries = malloc(reports * sizeof(prodVersionHistoryEntry_t));
+    store->deltas = malloc(reports * PRODVER_HISTORY_DELTA_MAX);
+    store->stints = malloc(reports * sizeof(prodVersionHistoryStint_t));
+    return store->entries && store->deltas && store->stints &&
+           prodVersionHistoryInit(&store->history, store->entries, reports, store->deltas, reports * PRODVER_HISTORY_DELTA_MAX, store->stints, reports);
+}
+
+static void storeFree(store_t* store)
+{
+    free(store->entries);
+    free(store->deltas);
+    free(store->stints);
+}
+
+/// @brief Model of prodVersionHistoryAt over canonical reports sorted by (device, time).
+static const prodVersionReport_t* modelAt(const prodVersionReport_t* all, const size_t count, const uint64_t deviceId, const uint64_t time)
+{
+    const prodVersionReport_t* found = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (all[i].deviceId == deviceId && all[i].time <= time) {
+            found = &all[i];
+        }
+    }
+    return found;
+}
+
+/// @brief Model of prodVersionHistoryLeft.
+static bool modelLeft(const prodVersionReport_t* all, const size_t count, const uint64_t deviceId, const char* canonical, const uint64_t since, uint64_t* ret_leaveTime)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (all[i].deviceId != deviceId || memcmp(all[i].encoded, canonical, PRODVER_ENCODED_LEN) != 0) {
+            continue;
+        }
+        if (i > 0 && all[i - 1].deviceId == deviceId && memcmp(all[i - 1].encoded, canonical, PRODVER_ENCODED_LEN) == 0) {
+            continue;
+        }
+
+        //  Start of a stint, find where it ends
+        size_t j = i + 1;
+        while (j < count && all[j].deviceId == deviceId && memcmp(all[j].encoded, canonical, PRODVER_ENCODED_LEN) == 0) {
+            j++;
+        }
+        uint64_t leaveTime = (j < count && all[j].deviceId == deviceId) ? all[j].time : UINT64_MAX;
+        if (leaveTime > since) {
+            *ret_leaveTime = leaveTime;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int checkQueries(const store_t* store, const prodVersionReport_t* all, const size_t count, const uint64_t maxTime)
+{
+    for (int q = 0; q < 2000; q++) {
+        uint64_t deviceId = rng() % (DEVICES + 2);
+        uint64_t time = rng() % (maxTime + 2);
+
+        char got[PRODVER_ENCODED_LEN];
+        uint64_t reportTime = 0;
+        const prodVersionReport_t* want = modelAt(all, count, deviceId, time);
+        CHECK(prodVersionHistoryAt(&store->history, deviceId, time, got, &reportTime) == (want != NULL));
+        if (want) {
+            CHECK(reportTime == want->time);
+            CHECK(memcmp(got, want->encoded, PRODVER_ENCODED_LEN) == 0);
+        }
+
+        //  Query with a non-canonical encoding of the version
+        char encoded[PRODVER_ENCODED_LEN];
+        char canonical[PRODVER_ENCODED_LEN];
+        makeEncoding(encoded, (unsigned)(rng() % VERSIONS));
+        memcpy(canonical, encoded, sizeof(encoded));
+        prodVersionCanonicalizeBytes(canonical, sizeof(canonical));
+
+        uint64_t leave = 0;
+        uint64_t wantLeave = 0;
+        bool found = modelLeft(all, count, deviceId, canonical, time, &wantLeave);
+        CHECK(prodVersionHistoryLeft(&store->history, deviceId, encoded, time, &leave) == found);
+        CHECK(!found || leave == wantLeave);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t total = (argc > 1) ? strtoul(argv[1], NULL, 10) : 6000;
+    rngState = (argc > 2) ? strtoull(argv[2], NULL, 10) : 0x9E3779B97F4A7C15ull;
+    if (rngState == 0) {
+        rngState = 1;
+    }
+
+    //  Every device reports at strictly increasing times; versions change now and then
+    prodVersionReport_t* all = malloc(total * sizeof(prodVersionReport_t));
+    prodVersionReport_t* batch = malloc(total * sizeof(prodVersionReport_t));
+    uint64_t deviceTime[DEVICES] = { 0 };
+    unsigned deviceVersion[DEVICES] = { 0 };
+    store_t store;
+    store_t whole;
+    CHECK(all && batch && storeInit(&store, total) && storeInit(&whole, total));
+
+    uint64_t maxTime = 0;
+    for (size_t i = 0; i < total; i++) {
+        uint64_t deviceId = rng() % DEVICES;
+        deviceTime[deviceId] += 1 + rng() % 50;
+        if (rng() % 6 == 0) {
+            deviceVersion[deviceId] = (unsigned)(rng() % VERSIONS);
+        }
+
+        all[i].deviceId = deviceId;
+        all[i].time = deviceTime[deviceId];
+        makeEncoding(all[i].encoded, deviceVersion[deviceId]);
+        if (all[i].time > maxTime) {
+            maxTime = all[i].time;
+        }
+    }
+
+    //  Append in arrival order, in batches of random size, checking queries as the history grows
+    size_t done = 0;
+    int batches = 0;
+    for (int b = 0; done < total; b++, batches++) {
+        size_t n = (b == BATCHES - 1) ? total - done : 1 + (size_t)(rng() % (2 * total / BATCHES + 1));
+        if (n > total - done) {
+            n = total - done;
+        }
+
+        memcpy(batch, all + done, n * sizeof(prodVersionReport_t));
+        CHECK(prodVersionHistoryAppend(&store.history, batch, n));
+        done += n;
+
+        //  Model: the reports so far, canonical and sorted
+        memcpy(batch, all, done * sizeof(prodVersionReport_t));
+        for (size_t i = 0; i < done; i++) {
+            prodVersionCanonicalizeBytes(batch[i].encoded, PRODVER_ENCODED_LEN);
+        }
+        qsort(batch, done, sizeof(prodVersionReport_t), prodVersionReportCompare);
+        CHECK(store.history.count == done);
+        if (checkQueries(&store, batch, done, maxTime)) {
+            return 1;
+        }
+    }
+
+    //  One build of everything gives the same entries and stints
+    memcpy(batch, all, total * sizeof(prodVersionReport_t));
+    CHECK(prodVersionHistoryBuild(&whole.history, batch, total));
+    CHECK(whole.history.stintCount == store.history.stintCount);
+    CHECK(memcmp(whole.stints, store.stints, store.history.stintCount * sizeof(prodVersionHistoryStint_t)) == 0);
+    for (size_t i = 0; i < total; i++) {
+        char a[PRODVER_ENCODED_LEN];
+        char b[PRODVER_ENCODED_LEN];
+        prodVersionHistoryReconstruct(&whole.history, i, a);
+        prodVersionHistoryReconstruct(&store.history, i, b);
+        CHECK(whole.entries[i].deviceId == store.entries[i].deviceId && whole.entries[i].time == store.entries[i].time);
+        CHECK(memcmp(a, b, PRODVER_ENCODED_LEN) == 0);
+    }
+
+    //  Garbage after terminators never starts a stint; only real version changes do
+    size_t changes = 0;
+    memcpy(batch, all, total * sizeof(prodVersionReport_t));
+    for (size_t i = 0; i < total; i++) {
+        prodVersionCanonicalizeBytes(batch[i].encoded, PRODVER_ENCODED_LEN);
+    }
+    qsort(batch, total, sizeof(prodVersionReport_t), prodVersionReportCompare);
+    for (size_t i = 0; i < total; i++) {
+        changes += (i == 0 || batch[i - 1].deviceId != batch[i].deviceId || memcmp(batch[i - 1].encoded, batch[i].encoded, PRODVER_ENCODED_LEN) != 0);
+    }
+    CHECK(store.history.stintCount == changes);
+
+    //  Rejected batches leave the history as it was
+    prodVersionHistory_t before = store.history;
+    prodVersionReport_t late[2];
+    late[0] = all[0];
+    late[0].time = deviceTime[late[0].deviceId] + 10;
+    late[1] = all[0];
+    late[1].time = 0;
+    CHECK(!prodVersionHistoryAppend(&store.history, late, 2));
+    CHECK(memcmp(&before, &store.history, sizeof(before)) == 0);
+
+    late[0].encoded[PRODVER_OFS_STRUCTVER] = (char)(PRODVER_STRUCTVER + 1);
+    late[1].time = deviceTime[late[1].deviceId] + 20;
+    CHECK(!prodVersionHistoryAppend(&store.history, late, 2));
+    CHECK(!prodVersionHistoryAppend(&store.history, all, 1));
+    CHECK(memcmp(&before, &store.history, sizeof(before)) == 0);
+
+    printf("%zu reports in %d batches, %zu stints\n", total, batches, store.history.stintCount);
+
+    storeFree(&store);
+    storeFree(&whole);
+    free(all);
+    free(batch);
+    return 0;
+}
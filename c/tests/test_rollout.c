@@ -0,0 +1,88 @@
+/*
+    Production Version - Staged Rollout Test
+    Nick Daria (contact@nickdaria.com)
+
+    Checks wave membership across a simulated fleet, run by ctest:
+        - a device held back by an early wave's channel gate is picked up once
+          a later, wider wave that admits its channel goes live
+        - advancing the live waves never drops a device that was included
+        - each wave covers roughly its share of the buckets
+
+    Usage:  test_rollout [devices]
+*/
+
+#include <stdlib.h>
+
+#include "prodversion_rollout.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s (device %llu)\n", __FILE__, __LINE__, #cond, (unsigned long long)device); return 1; } } while (0)
+
+static const prodVersionChannel_t channels[] = {
+    VERSION_CHANNEL_DEV, VERSION_CHANNEL_INTERNAL, VERSION_CHANNEL_ALPHA, VERSION_CHANNEL_BETA,
+    VERSION_CHANNEL_CANDIDATE, VERSION_CHANNEL_RELEASE, VERSION_CHANNEL_FACTORY,
+};
+
+#define CHANNEL_COUNT  (sizeof(channels) / sizeof(channels[0]))
+
+int main(int argc, char** argv)
+{
+    uint64_t devices = (argc > 1) ? strtoull(argv[1], NULL, 10) : 200000;
+    uint64_t device = 0;
+
+    prodVersion_t release;
+    memset(&release, 0, sizeof(release));
+    strcpy(release.product, "rollout-test");
+    release.major = 2;
+    release.minor = 4;
+    release.releaseChannel = VERSION_CHANNEL_RELEASE;
+
+    //  1% canary to beta devices only, then everyone
+    prodVersionRollout_t rollout;
+    CHECK(prodVersionRolloutInit(&rollout, &release, NULL));
+    CHECK(prodVersionRolloutAddWave(&rollout, 100, PRODVER_CHANNEL_BIT(VERSION_CHANNEL_BETA)));
+    CHECK(prodVersionRolloutAddWave(&rollout, PRODVER_ROLLOUT_BUCKETS, PRODVER_CHANNEL_MASK_LADDER));
+    CHECK(!prodVersionRolloutAddWave(&rollout, 50, PRODVER_CHANNEL_MASK_LADDER));
+
+    uint64_t canary = 0;
+    uint64_t heldBack = 0;
+    for (device = 0; device < devices; device++) {
+        int wave = prodVersionRolloutWaveOf(&rollout, device);
+        CHECK(wave == 0 || wave == 1);
+        canary += (wave == 0);
+
+        for (size_t c = 0; c < CHANNEL_COUNT; c++) {
+            prodVersionChannel_t channel = channels[c];
+            bool eligible = prodVersionChannelEligible(channel, release.releaseChannel);
+            bool included[3];
+            for (uint8_t active = 0; active <= 2; active++) {
+                CHECK(prodVersionRolloutSetActive(&rollout, active));
+                included[active] = prodVersionRolloutIncludes(&rollout, device, channel, NULL);
+            }
+
+            //  Nothing before the first wave, and a wave going live never removes anyone
+            CHECK(!included[0]);
+            CHECK(!included[1] || included[2]);
+
+            //  Canary admits only beta devices in its buckets
+            CHECK(included[1] == (wave == 0 && channel == VERSION_CHANNEL_BETA));
+
+            //  With both waves live every ladder device that may install the release is in, whatever its first wave
+            CHECK(included[2] == (eligible && (prodVersionChannelMask(channel) & PRODVER_CHANNEL_MASK_LADDER)));
+            if (wave == 0 && channel == VERSION_CHANNEL_RELEASE) {
+                CHECK(included[2]);
+                heldBack++;
+            }
+        }
+    }
+
+    CHECK(!prodVersionRolloutSetActive(&rollout, 3));
+
+    //  Canary share within a generous band around 1%
+    if (devices >= 100000) {
+        CHECK(canary > devices / 200 && canary < devices / 50);
+        CHECK(heldBack == canary);
+    }
+
+    printf("%llu devices, %llu in the canary wave\n", (unsigned long long)devices, (unsigned long long)canary);
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*
+    Production Version - Persistent Storage Test
+    Nick Daria (contact@nickdaria.com)
+
+    Drives prodversion_storage.h through the file-backed simulator, in flash
+    (erase before write) and EEPROM modes, run by ctest:
+        - an empty device mounts with no record, then writes survive remounts
+        - power loss at every byte of a write leaves the previous record, both
+          in memory and after remounting
+        - a slot failing its CRC is skipped in favour of the other slot
+        - the newer slot still wins when the sequence number wraps
+
+    Usage:  test_storage [path]
+*/
+
+#include "prodversion_storage_file.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s (%s)\n", __FILE__, __LINE__, #cond, flash ? "flash" : "eeprom"); return 1; } } while (0)
+
+/// Slot A sits past the start of the file and slots are a sector apart, leaving gaps
+#define BASE           100
+#define STRIDE         256
+
+typedef struct {
+    prodVersionFileDev_t file;
+    prodVersionBlockDev_t dev;
+    prodVersionStorage_t storage;
+} sim_t;
+
+static void makeVersion(prodVersion_t* version, const uint16_t build)
+{
+    memset(version, 0, sizeof(prodVersion_t));
+    strcpy(version->product, "storage-test");
+    strcpy(version->commitHash, "abc1234");
+    version->major = 3;
+    version->build = build;
+    version->releaseChannel = VERSION_CHANNEL_BETA;
+    version->date = 1700000000ull + build;
+}
+
+/// @brief Closes and reopens the backing file, then mounts it.
+static bool remount(sim_t* sim, const char* path, const bool flash)
+{
+    prodVersionFileDevClose(&sim->file);
+    return prodVersionFileDevOpen(&sim->file, &sim->dev, path, flash) &&
+           prodVersionStorageMount(&sim->storage, &sim->dev, BASE, STRIDE);
+}
+
+/// @brief True if the mounted record is the given build.
+static bool holds(const prodVersionStorage_t* storage, const uint16_t build)
+{
+    prodVersion_t expected;
+    prodVersion_t version;
+    makeVersion(&expected, build);
+    return prodVersionStorageRead(storage, &version) && prodVersionCompare(&version, &expected) == 0 &&
+           version.date == expected.date && strcmp(version.product, expected.product) == 0;
+}
+
+/// @brief Flips one byte of the file in place.
+static bool corrupt(sim_t* sim, const uint32_t offset)
+{
+    uint8_t b;
+    return prodVersionFileDevRead(&sim->file, offset, &b, 1) && (b ^= 0x5A, true) &&
+           fseek(sim->file.file, (long)offset, SEEK_SET) == 0 && fwrite(&b, 1, 1, sim->file.file) == 1 && fflush(sim->file.file) == 0;
+}
+
+static int run(const char* path, const bool flash)
+{
+    sim_t sim;
+    prodVersion_t version;
+    remove(path);
+    memset(&sim, 0, sizeof(sim));
+
+    //  Empty device
+    CHECK(remount(&sim, path, flash));
+    CHECK(sim.storage.active < 0);
+    CHECK(!prodVersionStorageRead(&sim.storage, &version));
+
+    //  Writes alternate slots and survive a remount
+    uint16_t build = 1;
+    for (; build <= 3; build++) {
+        makeVersion(&version, build);
+        CHECK(prodVersionStorageWrite(&sim.storage, &version));
+        CHECK(holds(&sim.storage, build));
+        CHECK(sim.storage.active == (build - 1) % 2);
+    }
+    build--;
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, build) && sim.storage.sequence == 3);
+
+    //  Gap before slot A was filled as erased
+    uint8_t gap[BASE];
+    CHECK(prodVersionFileDevRead(&sim.file, 0, gap, sizeof(gap)));
+    for (size_t i = 0; i < sizeof(gap); i++) {
+        CHECK(gap[i] == 0xFF);
+    }
+
+    //  Power loss at every byte of the next write
+    for (size_t cut = 1; cut < PRODVER_SLOT_LEN; cut++) {
+        int active = sim.storage.active;
+        sim.file.tearNextWriteAt = cut;
+        makeVersion(&version, (uint16_t)(build + 1));
+        CHECK(!prodVersionStorageWrite(&sim.storage, &version));
+        CHECK(holds(&sim.storage, build) && sim.storage.active == active);
+
+        CHECK(remount(&sim, path, flash));
+        CHECK(holds(&sim.storage, build) && sim.storage.active == active);
+    }
+
+    //  A completed write after all that
+    makeVersion(&version, ++build);
+    CHECK(prodVersionStorageWrite(&sim.storage, &version));
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, build));
+
+    //  Corrupt the newest slot's payload, then its CRC: the older record comes back
+    int newest = sim.storage.active;
+    uint32_t newestOffset = BASE + (uint32_t)newest * STRIDE;
+    CHECK(corrupt(&sim, newestOffset + PRODVER_SLOT_HEADER_LEN + 5));
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, (uint16_t)(build - 1)) && sim.storage.active == 1 - newest);
+
+    CHECK(corrupt(&sim, newestOffset + PRODVER_SLOT_HEADER_LEN + 5));
+    CHECK(corrupt(&sim, newestOffset + PRODVER_SLOT_LEN - 1));
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, (uint16_t)(build - 1)));
+
+    //  Both slots bad: mounts with no record
+    CHECK(corrupt(&sim, BASE + (uint32_t)(1 - newest) * STRIDE + PRODVER_SLOT_LEN - 1));
+    CHECK(remount(&sim, path, flash));
+    CHECK(sim.storage.active < 0);
+
+    //  Sequence wraps from UINT32_MAX to 0, and 0 is newer
+    sim.storage.sequence = UINT32_MAX - 1;
+    makeVersion(&version, 100);
+    CHECK(prodVersionStorageWrite(&sim.storage, &version));
+    makeVersion(&version, 101);
+    CHECK(prodVersionStorageWrite(&sim.storage, &version));
+    CHECK(sim.storage.sequence == 0);
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, 101) && sim.storage.sequence == 0);
+
+    //  Torn write across the wrap keeps record 101
+    sim.file.tearNextWriteAt = PRODVER_SLOT_LEN / 2;
+    makeVersion(&version, 102);
+    CHECK(!prodVersionStorageWrite(&sim.storage, &version));
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, 101));
+
+    makeVersion(&version, 102);
+    CHECK(prodVersionStorageWrite(&sim.storage, &version));
+    CHECK(remount(&sim, path, flash));
+    CHECK(holds(&sim.storage, 102) && sim.storage.sequence == 1);
+
+    prodVersionFileDevClose(&sim.file);
+    remove(path);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc > 1) ? argv[1] : "test_storage.bin";
+    if (run(path, true) || run(path, false)) {
+        return 1;
+    }
+
+    printf("flash and eeprom storage checks passed\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+    Production Version - io_uring Bulk Loader Test
+    Nick Daria (contact@nickdaria.com)
+
+    Writes a file of encoded records spanning several chunks, with a few
+    corrupted records and a trailing partial record, then checks that
+    prodVersionLoadFile delivers every valid record at its index, counts the
+    rejected ones and stops early when asked. Run by ctest when liburing is
+    found.
+
+    Usage:  test_uring [path]
+*/
+
+#include "prodversion_uring.h"
+
+#define CHECK(cond)    do { if (!(cond)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); ret = 1; goto done; } } while (0)
+
+/// Enough records for several chunks per queue slot, not a whole number of chunks
+#define RECORDS        (PRODVER_URING_CHUNK_LEN / PRODVER_ENCODED_LEN * PRODVER_URING_QUEUE_DEPTH * 2 + 1234)
+
+/// Every REJECT_EVERY-th record has a bad structure version
+#define REJECT_EVERY   1000
+
+typedef struct {
+    uint8_t* seen;
+    uint64_t count;
+    uint64_t limit;
+    bool mismatch;
+} loadCtx_t;
+
+static void makeVersion(prodVersion_t* version, const uint64_t index)
+{
+    memset(version, 0, sizeof(prodVersion_t));
+    snprintf(version->product, sizeof(version->product), "uring-%llu", (unsigned long long)(index % 97));
+    version->major = (uint16_t)(index >> 16);
+    version->minor = (uint16_t)index;
+    version->releaseChannel = VERSION_CHANNEL_RELEASE;
+    version->date = index;
+}
+
+static bool onRecord(const prodVersion_t* version, uint64_t index, void* ctx)
+{
+    loadCtx_t* load = (loadCtx_t*)ctx;
+
+    prodVersion_t expected;
+    makeVersion(&expected, index);
+    if (index >= RECORDS || load->seen[index] || prodVersionCompare(version, &expected) != 0 ||
+        strcmp(version->product, expected.product) != 0 || version->date != index) {
+        load->mismatch = true;
+    } else {
+        load->seen[index] = 1;
+    }
+
+    load->count++;
+    return !load->limit || load->count < load->limit;
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc > 1) ? argv[1] : "test_uring.bin";
+    int ret = 0;
+    char* buf = malloc((size_t)RECORDS * PRODVER_ENCODED_LEN + PRODVER_ENCODED_LEN / 2);
+    loadCtx_t load = { calloc(RECORDS, 1), 0, 0, false };
+    FILE* f = NULL;
+
+    CHECK(buf && load.seen);
+
+    uint64_t expectRejected = 0;
+    for (uint64_t i = 0; i < RECORDS; i++) {
+        prodVersion_t version;
+        makeVersion(&version, i);
+        char* rec = buf + i * PRODVER_ENCODED_LEN;
+        CHECK(prodVersionEncodeBytes(rec, PRODVER_ENCODED_LEN, &version) == PRODVER_ENCODED_LEN);
+        if (i % REJECT_EVERY == REJECT_EVERY - 1) {
+            rec[PRODVER_OFS_STRUCTVER] = (char)(PRODVER_STRUCTVER + 1);
+            expectRejected++;
+        }
+    }
+
+    //  Trailing partial record, ignored by the loader
+    memset(buf + (size_t)RECORDS * PRODVER_ENCODED_LEN, 0x01, PRODVER_ENCODED_LEN / 2);
+
+    f = fopen(path, "wb");
+    CHECK(f);
+    CHECK(fwrite(buf, 1, (size_t)RECORDS * PRODVER_ENCODED_LEN + PRODVER_ENCODED_LEN / 2, f) == (size_t)RECORDS * PRODVER_ENCODED_LEN + PRODVER_ENCODED_LEN / 2);
+    CHECK(fclose(f) == 0);
+    f = NULL;
+
+    //  Whole file
+    uint64_t rejected = 0;
+    int64_t decoded = prodVersionLoadFile(path, onRecord, &load, &rejected);
+    CHECK(decoded == (int64_t)(RECORDS - expectRejected));
+    CHECK(rejected == expectRejected);
+    CHECK(!load.mismatch);
+    for (uint64_t i = 0; i < RECORDS; i++) {
+        CHECK(load.seen[i] == (i % REJECT_EVERY != REJECT_EVERY - 1));
+    }
+
+    //  Stopping early leaves no reads behind and reports what was delivered
+    memset(load.seen, 0, RECORDS);
+    load.count = 0;
+    load.limit = 5000;
+    decoded = prodVersionLoadFile(path, onRecord, &load, NULL);
+    CHECK(decoded == 5000 && load.count == 5000);
+    CHECK(!load.mismatch);
+
+    //  Missing file and bad arguments
+    CHECK(prodVersionLoadFile("test_uring.missing", onRecord, &load, NULL) == -ENOENT);
+    CHECK(prodVersionLoadFile(path, NULL, &load, NULL) == -EINVAL);
+
+    printf("%d records loaded, %llu rejected\n", RECORDS, (unsigned long long)rejected);
+
+done:
+    if (f) {
+        fclose(f);
+    }
+    remove(path);
+    free(buf);
+    free(load.seen);
+    return ret;
+}
@@ -0,0 +1,50 @@
+﻿using System;
+using System.IO;
+using System.Text;
+
+namespace ProdVersion.FuzzDump
+{
+    /// <summary>
+    /// Differential dump for c/fuzz/differential.sh. Reads input file paths on stdin and prints one
+    /// line per input in the same format as c/fuzz/fuzz_dump.c: skip, reject, or accept followed by
+    /// the re-encoded bytes and the ToString output (as Latin-1 bytes), both in hex.
+    /// </summary>
+    public static class Program
+    {
+        public static void Main()
+        {
+            string? path;
+            while ((path = Console.ReadLine()) != null)
+            {
+                byte[] buffer = File.ReadAllBytes(path);
+                if (buffer.Length != 64)
+                {
+                    Console.WriteLine("skip");
+                    continue;
+                }
+
+                VersionInfo version;
+                try
+                {
+                    if (!VersionInfo.Decode(buffer, out version))
+                    {
+                        Console.WriteLine("skip");
+                        continue;
+                    }
+                }
+                catch (NotImplementedException)
+                {
+                    Console.WriteLine("reject");
+                    continue;
+                }
+
+                byte[] encoded = VersionInfo.Encode(version);
+
+                StringBuilder line = new StringBuilder("accept ");
+                line.Append(Convert.ToHexStringLower(encoded));
+                line.Append(' ').Append(Convert.ToHexStringLower(Encoding.Latin1.GetBytes(version.ToString())));
+                Console.WriteLine(line.ToString());
+            }
+        }
+    }
+}
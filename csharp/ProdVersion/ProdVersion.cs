@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Buffers.Binary;
 using System.Runtime.InteropServices;
 using System.Text;
 
@@ -17,10 +18,27 @@ namespace ProdVersion
 
     public struct VersionInfo
     {
-        private const byte ENCODING_VERSION = 0x01;
-        private const int PRODUCT_SIZE = 24;
-        private const int METADATA_SIZE = 15;
-        private const int COMMIT_HASH_SIZE = 7;
+        internal const byte ENCODING_VERSION = 0x01;
+        internal const int ENCODED_SIZE = 64;
+        internal const int PRODUCT_SIZE = 24;
+        internal const int METADATA_SIZE = 15;
+        internal const int COMMIT_HASH_SIZE = 7;
+
+        internal const int PRODUCT_OFFSET = 1;
+        internal const int MAJOR_OFFSET = 25;
+        internal const int MINOR_OFFSET = 27;
+        internal const int PATCH_OFFSET = 29;
+        internal const int BUILD_OFFSET = 31;
+        internal const int CHANNEL_OFFSET = 33;
+        internal const int METADATA_OFFSET = 34;
+        internal const int COMMIT_HASH_OFFSET = 49;
+        internal const int DATE_OFFSET = 56;
+
+        /// <summary>
+        /// String fields are ASCII, but bytes outside it are carried one-to-one (Latin-1) rather than replaced
+        /// with '?', so decoding and re-encoding keeps the bytes the C library keeps.
+        /// </summary>
+        internal static readonly Encoding FieldEncoding = Encoding.Latin1;
 
         private string _product;
         private ushort _major;
@@ -107,6 +125,12 @@ namespace ProdVersion
             set => _unixTimestamp = (ulong)new DateTimeOffset(value).ToUnixTimeSeconds();
         }
 
+        internal ulong UnixTimestamp
+        {
+            get => _unixTimestamp;
+            set => _unixTimestamp = value;
+        }
+
         public static byte[] Encode(VersionInfo version)
         {
             byte[] buffer = new byte[64];
@@ -116,7 +140,7 @@ namespace ProdVersion
             buffer[offset++] = ENCODING_VERSION;
 
             //  Product/Part ID
-            Encoding.ASCII.GetBytes(version.Product).CopyTo(buffer, offset);
+            SetCString(buffer, offset, PRODUCT_SIZE, version.Product);
             offset += PRODUCT_SIZE;
 
             //  Semantic version
@@ -136,11 +160,11 @@ namespace ProdVersion
             buffer[offset++] = (byte)version.ReleaseChannel;
 
             //  Metadata
-            Encoding.ASCII.GetBytes(version.Metadata).CopyTo(buffer, offset);
+            SetCString(buffer, offset, METADATA_SIZE, version.Metadata);
             offset += METADATA_SIZE;
 
             //  Commit hash
-            Encoding.ASCII.GetBytes(version.CommitHash).CopyTo(buffer, offset);
+            SetCString(buffer, offset, COMMIT_HASH_SIZE, version.CommitHash);
             offset += COMMIT_HASH_SIZE;
 
             //  Timestamp
@@ -203,9 +227,30 @@ namespace ProdVersion
             return true;
         }
 
+        internal static ReadOnlySpan<byte> GetCSpan(ReadOnlySpan<byte> buffer, int offset, int length)
+        {
+            ReadOnlySpan<byte> field = buffer.Slice(offset, length);
+
+            int nullIndex = field.IndexOf((byte)0);
+            return nullIndex >= 0 ? field.Slice(0, nullIndex) : field;
+        }
+
+        /// <summary>
+        /// Writes a string field in canonical form: characters up to the first '\0' and zero padding after,
+        /// matching the C encoder so equal versions always encode to identical bytes.
+        /// </summary>
+        private static void SetCString(byte[] buffer, int offset, int length, string value)
+        {
+            int nullIndex = value.IndexOf('\0');
+            if (nullIndex >= 0)
+                value = value.Substring(0, nullIndex);
+
+            FieldEncoding.GetBytes(value, 0, Math.Min(value.Length, length), buffer, offset);
+        }
+
         private static string GetCString(byte[] buffer, int offset, int length)
         {
-            string str = Encoding.ASCII.GetString(buffer, offset, length);
+            string str = FieldEncoding.GetString(buffer, offset, length);
 
             int nullIndex = str.IndexOf('\0');
             if (nullIndex >= 0)
@@ -231,4 +276,83 @@ namespace ProdVersion
             );
         }
     }
+
+    /// <summary>
+    /// Read-only view over a 64-byte encoding. Numeric fields are read in place and strings are only
+    /// allocated when their properties are read, so filtering by product or commit hash does not
+    /// allocate. Call <see cref="ToVersionInfo"/> to keep a record beyond the buffer's lifetime.
+    /// </summary>
+    public readonly ref struct VersionView
+    {
+        private readonly ReadOnlySpan<byte> _buffer;
+
+        private VersionView(ReadOnlySpan<byte> buffer)
+        {
+            _buffer = buffer;
+        }
+
+        public static bool TryCreate(ReadOnlySpan<byte> buffer, out VersionView view)
+        {
+            view = default;
+            if (buffer.Length != VersionInfo.ENCODED_SIZE)
+                return false;
+
+            //  Verify structure version
+            byte ver = buffer[0];
+            if(ver != VersionInfo.ENCODING_VERSION) { throw new NotImplementedException($"Unsupported structure version: {ver}"); }
+
+            view = new VersionView(buffer);
+            return true;
+        }
+
+        /// <summary>Product as raw ASCII, without the terminator</summary>
+        public ReadOnlySpan<byte> ProductBytes => VersionInfo.GetCSpan(_buffer, VersionInfo.PRODUCT_OFFSET, VersionInfo.PRODUCT_SIZE);
+
+        /// <summary>Metadata as raw ASCII, without the terminator</summary>
+        public ReadOnlySpan<byte> MetadataBytes => VersionInfo.GetCSpan(_buffer, VersionInfo.METADATA_OFFSET, VersionInfo.METADATA_SIZE);
+
+        /// <summary>Commit hash as raw ASCII, without the terminator</summary>
+        public ReadOnlySpan<byte> CommitHashBytes => VersionInfo.GetCSpan(_buffer, VersionInfo.COMMIT_HASH_OFFSET, VersionInfo.COMMIT_HASH_SIZE);
+
+        public string Product => VersionInfo.FieldEncoding.GetString(ProductBytes);
+        public string Metadata => VersionInfo.FieldEncoding.GetString(MetadataBytes);
+        public string CommitHash => VersionInfo.FieldEncoding.GetString(CommitHashBytes);
+
+        public ushort Major => BinaryPrimitives.ReadUInt16BigEndian(_buffer.Slice(VersionInfo.MAJOR_OFFSET));
+        public ushort Minor => BinaryPrimitives.ReadUInt16BigEndian(_buffer.Slice(VersionInfo.MINOR_OFFSET));
+        public ushort Patch => BinaryPrimitives.ReadUInt16BigEndian(_buffer.Slice(VersionInfo.PATCH_OFFSET));
+        public ushort Build => BinaryPrimitives.ReadUInt16BigEndian(_buffer.Slice(VersionInfo.BUILD_OFFSET));
+
+        public ReleaseChannel ReleaseChannel => (ReleaseChannel)_buffer[VersionInfo.CHANNEL_OFFSET];
+
+        public DateTime Date => DateTimeOffset.FromUnixTimeSeconds((long)UnixTimestamp).UtcDateTime;
+
+        private ulong UnixTimestamp => BinaryPrimitives.ReadUInt64BigEndian(_buffer.Slice(VersionInfo.DATE_OFFSET));
+
+        /// <summary>Compares the product against raw ASCII bytes without materializing a string</summary>
+        public bool ProductEquals(ReadOnlySpan<byte> product) => ProductBytes.SequenceEqual(product);
+
+        /// <summary>Compares the metadata against raw ASCII bytes without materializing a string</summary>
+        public bool MetadataEquals(ReadOnlySpan<byte> metadata) => MetadataBytes.SequenceEqual(metadata);
+
+        /// <summary>Compares the commit hash against raw ASCII bytes without materializing a string</summary>
+        public bool CommitHashEquals(ReadOnlySpan<byte> commitHash) => CommitHashBytes.SequenceEqual(commitHash);
+
+        /// <summary>Materializes every field into a <see cref="VersionInfo"/></summary>
+        public VersionInfo ToVersionInfo()
+        {
+            return new VersionInfo
+            {
+                Product = Product,
+                Major = Major,
+                Minor = Minor,
+                Patch = Patch,
+                Build = Build,
+                ReleaseChannel = ReleaseChannel,
+                Metadata = Metadata,
+                CommitHash = CommitHash,
+                UnixTimestamp = UnixTimestamp
+            };
+        }
+    }
 }
@@ -0,0 +1,44 @@
+"""
+Production Version - Python
+Nick Daria (contact@nickdaria.com)
+
+Bulk decoding of 64-byte prodversion encodings into NumPy structured arrays,
+backed by the C codec. Decoding runs without the GIL.
+
+    import prodversion
+    versions = prodversion.decode(open("snapshot.bin", "rb").read())
+    df = pandas.DataFrame(versions)
+"""
+
+import numpy as np
+
+from ._codec import ENCODED_LEN, RECORD_LEN, decode_into
+
+__all__ = ["DTYPE", "ENCODED_LEN", "decode", "decode_into"]
+
+#: Decoded record, one row per encoding. Rows that fail to decode are zeroed with valid=False.
+DTYPE = np.dtype([
+    ("product", "S24"),
+    ("major", "<u2"),
+    ("minor", "<u2"),
+    ("patch", "<u2"),
+    ("build", "<u2"),
+    ("channel", "S1"),
+    ("metadata", "S15"),
+    ("commit", "S7"),
+    ("date", "<u8"),
+    ("valid", "?"),
+])
+
+assert DTYPE.itemsize == RECORD_LEN
+
+
+def decode(data):
+    """Decodes a bytes-like object of N * 64 encodings into an array of N DTYPE records."""
+    view = memoryview(data).cast("B")
+    if len(view) % ENCODED_LEN:
+        raise ValueError(f"encoded data length {len(view)} is not a multiple of {ENCODED_LEN}")
+
+    out = np.empty(len(view) // ENCODED_LEN, dtype=DTYPE)
+    decode_into(view, out)
+    return out
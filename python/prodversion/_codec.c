@@ -0,0 +1,119 @@
+/*
+    Production Version - Python Codec
+    Nick Daria (contact@nickdaria.com)
+
+    Bulk decode of back-to-back 64-byte encodings into a caller-provided
+    buffer of PRODVER_PY_RECORD_LEN byte records, laid out to match
+    prodversion.DTYPE. The array is allocated on the Python side, so this
+    module needs no NumPy headers and works against any NumPy version.
+
+    Record layout (little-endian, packed):
+        [0 - 23]    product
+        [24 - 31]   major, minor, patch, build (uint16)
+        [32]        releaseChannel
+        [33 - 47]   metadata
+        [48 - 54]   commitHash
+        [55 - 62]   date (uint64)
+        [63]        valid (1 if decoded, else the record is zeroed)
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "prodversion.h"
+
+#define PRODVER_PY_RECORD_LEN         64
+
+static void prodVersionPyPutLE(char* buf, uint64_t value, const size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) {
+        buf[i] = (char)(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+/// @brief Decodes count encodings into records. Runs without the GIL.
+/// @return Number of records decoded.
+static size_t prodVersionPyDecode(const char* src, char* dst, const size_t count)
+{
+    size_t decoded = 0;
+    for (size_t i = 0; i < count; i++) {
+        char* rec = dst + i * PRODVER_PY_RECORD_LEN;
+        memset(rec, 0, PRODVER_PY_RECORD_LEN);
+
+        prodVersion_t version;
+        if (!prodVersionDecodeBytes(src + i * PRODVER_ENCODED_LEN, PRODVER_ENCODED_LEN, &version)) {
+            continue;
+        }
+
+        memcpy(rec, version.product, PRODVER_FLD_PRODUCT_LEN);
+        prodVersionPyPutLE(rec + 24, version.major, 2);
+        prodVersionPyPutLE(rec + 26, version.minor, 2);
+        prodVersionPyPutLE(rec + 28, version.patch, 2);
+        prodVersionPyPutLE(rec + 30, version.build, 2);
+        rec[32] = (char)version.releaseChannel;
+        memcpy(rec + 33, version.metadata, PRODVER_FLD_METADATA_LEN);
+        memcpy(rec + 48, version.commitHash, PRODVER_FLD_COMMIT_LEN);
+        prodVersionPyPutLE(rec + 55, version.date, 8);
+        rec[63] = 1;
+        decoded++;
+    }
+    return decoded;
+}
+
+static PyObject* prodVersionPyDecodeInto(PyObject* self, PyObject* args)
+{
+    (void)self;
+
+    Py_buffer src;
+    Py_buffer dst;
+    if (!PyArg_ParseTuple(args, "y*w*", &src, &dst)) {
+        return NULL;
+    }
+
+    PyObject* result = NULL;
+    if (src.len % PRODVER_ENCODED_LEN != 0) {
+        PyErr_Format(PyExc_ValueError, "encoded data length %zd is not a multiple of %d", src.len, PRODVER_ENCODED_LEN);
+    } else if (dst.len != (src.len / PRODVER_ENCODED_LEN) * PRODVER_PY_RECORD_LEN) {
+        PyErr_SetString(PyExc_ValueError, "destination size does not match the record count");
+    } else if (!PyBuffer_IsContiguous(&src, 'C') || !PyBuffer_IsContiguous(&dst, 'C')) {
+        PyErr_SetString(PyExc_ValueError, "buffers must be contiguous");
+    } else {
+        size_t count = (size_t)src.len / PRODVER_ENCODED_LEN;
+        size_t decoded;
+
+        Py_BEGIN_ALLOW_THREADS
+        decoded = prodVersionPyDecode((const char*)src.buf, (char*)dst.buf, count);
+        Py_END_ALLOW_THREADS
+
+        result = PyLong_FromSize_t(decoded);
+    }
+
+    PyBuffer_Release(&src);
+    PyBuffer_Release(&dst);
+    return result;
+}
+
+static PyMethodDef prodVersionPyMethods[] = {
+    { "decode_into", prodVersionPyDecodeInto, METH_VARARGS,
+      "decode_into(data, out) -> int\n\n"
+      "Decodes back-to-back 64-byte encodings from data into the writable buffer out\n"
+      "(64 bytes per record, prodversion.DTYPE layout). Returns the number decoded." },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef prodVersionPyModule = {
+    PyModuleDef_HEAD_INIT, "_codec", NULL, -1, prodVersionPyMethods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit__codec(void)
+{
+    PyObject* module = PyModule_Create(&prodVersionPyModule);
+    if (module && (PyModule_AddIntConstant(module, "ENCODED_LEN", PRODVER_ENCODED_LEN) < 0 ||
+                   PyModule_AddIntConstant(module, "RECORD_LEN", PRODVER_PY_RECORD_LEN) < 0)) {
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -0,0 +1,19 @@
+from setuptools import Extension, setup
+
+setup(
+    name="prodversion",
+    version="1.0.0",
+    description="Production Version bulk decoding into NumPy structured arrays",
+    author="Nick Daria",
+    author_email="contact@nickdaria.com",
+    packages=["prodversion"],
+    ext_modules=[
+        Extension(
+            "prodversion._codec",
+            sources=["prodversion/_codec.c"],
+            include_dirs=["../c"],
+        )
+    ],
+    install_requires=["numpy"],
+    python_requires=">=3.8",
+)
@@ -0,0 +1,104 @@
+"""
+Production Version - Python Decode Test
+Nick Daria (contact@nickdaria.com)
+
+Checks the NumPy bulk decoder against encodings built by hand:
+    - DTYPE matches the 64-byte record layout written by _codec.c
+    - valid encodings decode to their fields, including full-length strings
+    - records with a bad structure version are zeroed with valid=False
+    - wrongly sized sources and destinations raise ValueError
+
+Usage:  python3 setup.py build_ext --inplace && python3 -m pytest tests
+"""
+
+import struct
+
+import numpy as np
+import pytest
+
+import prodversion
+
+
+def encode(product=b"", major=0, minor=0, patch=0, build=0, channel=b"r", metadata=b"", commit=b"", date=0, structver=1):
+    """Encodes a version the way prodVersionEncodeBytes lays it out."""
+    return struct.pack(
+        ">B24sHHHHc15s7sQ",
+        structver, product, major, minor, patch, build, channel, metadata, commit, date,
+    )
+
+
+def test_dtype_layout():
+    assert prodversion.ENCODED_LEN == 64
+    assert prodversion.DTYPE.itemsize == 64
+
+    offsets = {name: prodversion.DTYPE.fields[name][1] for name in prodversion.DTYPE.names}
+    assert offsets == {
+        "product": 0,
+        "major": 24,
+        "minor": 26,
+        "patch": 28,
+        "build": 30,
+        "channel": 32,
+        "metadata": 33,
+        "commit": 48,
+        "date": 55,
+        "valid": 63,
+    }
+
+
+def test_decode_valid():
+    data = encode(b"sensor", 1, 2, 3, 42, b"b", b"stripped", b"7b5a2fe", 1700000000) + \
+        encode(b"P" * 24, 65535, 0, 65535, 0, b"f", b"M" * 15, b"c" * 7, 2**64 - 1)
+
+    out = prodversion.decode(data)
+    assert out.dtype == prodversion.DTYPE
+    assert out.shape == (2,)
+
+    first = out[0]
+    assert first["product"] == b"sensor"
+    assert (first["major"], first["minor"], first["patch"], first["build"]) == (1, 2, 3, 42)
+    assert first["channel"] == b"b"
+    assert first["metadata"] == b"stripped"
+    assert first["commit"] == b"7b5a2fe"
+    assert first["date"] == 1700000000
+    assert first["valid"]
+
+    second = out[1]
+    assert second["product"] == b"P" * 24
+    assert second["metadata"] == b"M" * 15
+    assert second["commit"] == b"c" * 7
+    assert (second["major"], second["patch"]) == (65535, 65535)
+    assert second["date"] == 2**64 - 1
+    assert second["valid"]
+
+
+def test_decode_invalid_zeroed():
+    good = encode(b"gateway", 10, channel=b"r", date=5)
+    bad = encode(b"gateway", 10, channel=b"r", date=5, structver=2)
+
+    out = np.empty(3, dtype=prodversion.DTYPE)
+    out.view(np.uint8)[:] = 0xFF
+    assert prodversion.decode_into(good + bad + good, out) == 2
+
+    assert list(out["valid"]) == [True, False, True]
+    assert out[1].tobytes() == bytes(64)
+    assert out[2]["product"] == b"gateway" and out[2]["major"] == 10
+
+
+def test_decode_empty():
+    out = prodversion.decode(b"")
+    assert out.shape == (0,)
+    assert out.dtype == prodversion.DTYPE
+
+
+def test_wrong_sizes_rejected():
+    data = encode(b"x") * 2
+
+    with pytest.raises(ValueError):
+        prodversion.decode_into(data, np.empty(1, dtype=prodversion.DTYPE))
+    with pytest.raises(ValueError):
+        prodversion.decode_into(data, np.empty(3, dtype=prodversion.DTYPE))
+    with pytest.raises(ValueError):
+        prodversion.decode_into(data[:-1], np.empty(2, dtype=prodversion.DTYPE))
+    with pytest.raises(ValueError):
+        prodversion.decode(data + b"\x01")